@@ -13,6 +13,8 @@
 #include <algorithm>
 #include <limits>
 
+#include "sorting/arg_sort/arg_sort.h"
+
 struct Vec3
 {
   double x, y, z;
@@ -219,10 +221,11 @@ RatioResult sameSideAtLeastRatioThroughLine(const Vec3 &p1,
   if (!buildFrame(p1, p2, e1, e2, e3, eps)) return R; // degenerate line
 
   // Collect angles for points not on the line; count the "on-line" points
+  // Room for the +2π copies appended after sorting, so neither vector reallocates
   std::vector<double> ang;
-  ang.reserve(pts.size());
+  ang.reserve(2 * pts.size());
   std::vector<std::size_t> ang_idx;
-  ang_idx.reserve(pts.size());
+  ang_idx.reserve(2 * pts.size());
   std::size_t on_line = 0;
 
   for (std::size_t i = 0; i < pts.size(); ++i)
@@ -253,25 +256,14 @@ RatioResult sameSideAtLeastRatioThroughLine(const Vec3 &p1,
     return R;
   }
 
-  // Sort by angle and duplicate (+2π) for circular windowing
-  std::vector<std::size_t> order(ang.size());
-  std::iota(order.begin(), order.end(), 0);
-  std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return ang[a] < ang[b]; });
+  // Sort by angle, carrying the point indices along, and duplicate (+2π) in place for circular windowing
+  coSort(ang, ang_idx);
 
-  std::vector<double> a;
-  a.reserve(ang.size() * 2);
-  std::vector<std::size_t> ord;
-  ord.reserve(ang.size() * 2);
-  for (std::size_t id : order)
-  {
-    a.push_back(ang[id]);
-    ord.push_back(id);
-  }
-  const std::size_t M = a.size();
+  const std::size_t M = ang.size();
   for (std::size_t i = 0; i < M; ++i)
   {
-    a.push_back(a[i] + 2.0 * PI);
-    ord.push_back(ord[i]);
+    ang.push_back(ang[i] + 2.0 * PI);
+    ang_idx.push_back(ang_idx[i]);
   }
 
   // Sliding window: count max angles within any arc of width ≤ π
@@ -279,7 +271,7 @@ RatioResult sameSideAtLeastRatioThroughLine(const Vec3 &p1,
   std::size_t j = 0, max_in_arc = 0;
   for (std::size_t i = 0; i < M; ++i)
   {
-    while (j < i + M && a[j] - a[i] <= PI + 1e-15) ++j; // [i, j)
+    while (j < i + M && ang[j] - ang[i] <= PI + 1e-15) ++j; // [i, j)
     std::size_t cnt = j - i;
     if (cnt > max_in_arc)
     {
@@ -304,8 +296,8 @@ RatioResult sameSideAtLeastRatioThroughLine(const Vec3 &p1,
   // Place boundary at the bisector of the complementary gap; equivalent and simpler:
   // choose normal angle a_n pointing "into" the chosen arc (e.g., its mid-angle),
   // so that dot >= 0 for angles within the arc.
-  double a_left  = a[best_i];
-  double a_right = a[best_j - 1];
+  double a_left  = ang[best_i];
+  double a_right = ang[best_j - 1];
   // Arc midpoint (works because width ≤ π)
   double arc_mid = 0.5 * (a_left + a_right);
   // Normal direction in the (e2,e3) plane that gives non-negative dot for arc points:
@@ -323,11 +315,10 @@ RatioResult sameSideAtLeastRatioThroughLine(const Vec3 &p1,
     double x = dot(v, e2), y = dot(v, e3);
     if (std::fabs(x) <= eps && std::fabs(y) <= eps) R.inliers.push_back(i);
   }
-  // Add arc points (map back through ord -> ang_idx -> original index)
+  // Add arc points (ang_idx holds the original point indices)
   for (std::size_t k = best_i; k < best_j; ++k)
   {
-    std::size_t id = ord[k];
-    R.inliers.push_back(ang_idx[id]);
+    R.inliers.push_back(ang_idx[k]);
   }
 
   R.ok           = true;
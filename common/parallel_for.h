@@ -0,0 +1,35 @@
+#ifndef COMMON_PARALLEL_FOR_H
+#define COMMON_PARALLEL_FOR_H
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace bmath
+{
+// Number of worker threads to use when the caller passes 0
+inline std::size_t defaultThreadCount()
+{
+  return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+}
+
+// Run function(t) for t in [0, num_threads) on separate threads and wait for all of them.
+// The calling thread runs t = 0 itself.
+template <typename Function>
+void parallelFor(std::size_t num_threads, Function &&function)
+{
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads > 0 ? num_threads - 1 : 0);
+  for (std::size_t t = 1; t < num_threads; ++t)
+  {
+    threads.emplace_back([&function, t]() { function(t); });
+  }
+  if (num_threads > 0) { function(0); }
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+}
+} // namespace bmath
+
+#endif // COMMON_PARALLEL_FOR_H
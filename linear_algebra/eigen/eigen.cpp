@@ -38,5 +38,8 @@ void powerIteration(Scalar C[3][3], Scalar eigenvector[3], int max_iterations, S
   for (int i = 0; i < 3; i++)
     eigenvector[i] = v[i];
 }
+
+template void powerIteration<float>(float C[3][3], float eigenvector[3], int max_iterations, float tol);
+template void powerIteration<double>(double C[3][3], double eigenvector[3], int max_iterations, double tol);
 } // namespace linear_algebra
 } // namespace bmath
\ No newline at end of file
@@ -0,0 +1,2 @@
+
+#include "sorting/arg_sort/arg_sort.h"
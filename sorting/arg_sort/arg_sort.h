@@ -0,0 +1,148 @@
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "sorting/intro_sort/intro_sort.h"
+#include "sorting/radix_sort/radix_sort.h"
+
+#ifndef SORTING_ARG_SORT_H
+#define SORTING_ARG_SORT_H
+
+/*
+Argsort and struct-of-arrays co-sort, in place of an `std::iota` index vector sorted by a lambda that looks up
+keys[a] < keys[b], which costs an indirection into the key array on every comparison.
+
+The keys are copied next to their positions as packed (key, index) pairs, so every comparison reads one contiguous
+element. The pairs compare by key, then by index: any sort algorithm then yields the stable permutation, and the sort
+is pluggable (`introSort` by default, `radixSort` on the key for arithmetic keys). The index is 32-bit whenever the
+array allows it, which keeps a (float, index) pair in 8 bytes. Co-sorting writes the keys back from the pairs and
+gathers each payload array through the permutation once.
+
+|property|description|
+|---|---|
+|Time Complexity|the sort of n pairs, plus one gather pass per payload array.|
+|Space Complexity|O(n) pairs, plus one temporary array per payload while it is gathered.|
+|Stability|equal keys keep their input order whatever sort is plugged in.|
+|Sort|sort(std::vector<KeyIndex<Key, Index>> &) is any callable, e.g. `[](auto &pairs) { powerSort(pairs); }`.|
+*/
+
+// Gathers prefetch the element this many positions ahead in the permutation
+constexpr std::size_t kArgSortPrefetch = 8;
+
+template <typename Key, typename Index>
+struct KeyIndex
+{
+  Key key;
+  Index index;
+
+  bool operator<(const KeyIndex &other) const
+  {
+    return key < other.key || (!(other.key < key) && index < other.index);
+  }
+};
+
+// The default sort: LSD radix on the key (stable) for arithmetic keys, otherwise introSort on (key, index)
+struct ArgSortDefault
+{
+  template <typename Key, typename Index>
+  void operator()(std::vector<KeyIndex<Key, Index>> &pairs) const
+  {
+    if constexpr (std::is_arithmetic<Key>::value && !std::is_same<Key, bool>::value)
+    {
+      // -0.0 and +0.0 compare equal but differ in their bits: radix on +0.0 for both so they keep their input order
+      radixSort(pairs, [](const KeyIndex<Key, Index> &pair) { return pair.key == Key(0) ? Key(0) : pair.key; });
+    }
+    else { introSort(pairs); }
+  }
+};
+
+// Build the pairs of the n keys starting at first (a move_iterator moves the keys), sort them, and hand them to visit
+template <typename Iterator, typename Sort, typename Visit>
+void sortKeyIndices(Iterator first, std::size_t n, Sort &sort, Visit visit)
+{
+  using Key = typename std::iterator_traits<Iterator>::value_type;
+  auto run  = [&](auto index_tag) {
+    using Index = decltype(index_tag);
+    std::vector<KeyIndex<Key, Index>> pairs;
+    pairs.reserve(n);
+    for (std::size_t i = 0; i < n; ++i, ++first)
+    {
+      pairs.push_back({*first, static_cast<Index>(i)});
+    }
+    sort(pairs);
+    visit(pairs);
+  };
+  if (n <= std::numeric_limits<std::uint32_t>::max()) { run(std::uint32_t()); }
+  else { run(std::uint64_t()); }
+}
+
+// values[i] becomes the old values[index_of(order[i])]
+template <typename T, typename Order, typename IndexOf>
+void gatherByIndex(std::vector<T> &values, const std::vector<Order> &order, IndexOf index_of)
+{
+  const std::size_t n = order.size();
+  std::vector<T> gathered;
+  gathered.reserve(std::max(n, values.capacity())); // keep the room the caller reserved
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    if constexpr (!std::is_same<T, bool>::value) // std::vector<bool> has no element addresses
+    {
+      if (i + kArgSortPrefetch < n) { __builtin_prefetch(&values[index_of(order[i + kArgSortPrefetch])]); }
+    }
+    gathered.push_back(std::move(values[index_of(order[i])]));
+  }
+  values.swap(gathered);
+}
+
+// The permutation that sorts keys: keys[order[0]] <= keys[order[1]] <= ..., equal keys in input order
+template <typename T, typename Sort = ArgSortDefault>
+std::vector<std::size_t> argSort(const std::vector<T> &keys, Sort sort = Sort())
+{
+  std::vector<std::size_t> order(keys.size());
+  sortKeyIndices(keys.begin(), keys.size(), sort, [&](const auto &pairs) {
+    for (std::size_t i = 0; i < pairs.size(); ++i)
+    {
+      order[i] = pairs[i].index;
+    }
+  });
+  return order;
+}
+
+// Reorder values in place by a permutation from argSort: values[i] becomes the old values[order[i]]
+template <typename T>
+void applyPermutation(std::vector<T> &values, const std::vector<std::size_t> &order)
+{
+  if (values.size() != order.size()) { throw std::invalid_argument("applyPermutation: sizes differ"); }
+  gatherByIndex(values, order, [](const std::size_t &index) { return index; });
+}
+
+// Sort keys and reorder every payload array the same way, as if the arrays were the fields of one struct
+template <typename Sort, typename T, typename... Payloads>
+void coSortWith(Sort sort, std::vector<T> &keys, std::vector<Payloads> &...payloads)
+{
+  const std::size_t n = keys.size();
+  if (((payloads.size() != n) || ...)) { throw std::invalid_argument("coSort: payload sizes differ from the keys"); }
+
+  sortKeyIndices(std::make_move_iterator(keys.begin()), n, sort, [&](auto &pairs) {
+    using Pair = typename std::decay<decltype(pairs[0])>::type;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      keys[i] = std::move(pairs[i].key);
+    }
+    (gatherByIndex(payloads, pairs, [](const Pair &pair) { return static_cast<std::size_t>(pair.index); }), ...);
+  });
+}
+
+template <typename T, typename... Payloads>
+void coSort(std::vector<T> &keys, std::vector<Payloads> &...payloads)
+{
+  coSortWith(ArgSortDefault(), keys, payloads...);
+}
+
+#endif // SORTING_ARG_SORT_H
@@ -0,0 +1,167 @@
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#ifndef SORTING_BENCH_BENCH_DATA_H
+#define SORTING_BENCH_BENCH_DATA_H
+
+/*
+In-process key generators for the sorting benchmarks. Every distribution first produces integer ranks below 2^30 and
+maps them to keys with an order-preserving injection, so a distribution has the same order pattern, ties included, for
+int32, int64, float and double keys. Integer and double keys are the ranks themselves. A float has a 24-bit
+significand and cannot hold every such integer, so a float key is the rank-th float above 1.0f, which is what the
+rank added to the bit pattern of 1.0f gives.
+
+|distribution|keys|
+|---|---|
+|random|uniform ranks|
+|sorted|0, 1, 2, ...|
+|reversed|n - 1, n - 2, ..., 0|
+|organ_pipe|ascending to the middle, then descending|
+|few_unique|16 distinct ranks|
+|zipf|Zipf(s = 1) over min(n, 2^20) distinct ranks, the ranks scattered so frequent keys are not the smallest|
+*/
+
+enum class BenchDistribution
+{
+  kRandom,
+  kSorted,
+  kReversed,
+  kOrganPipe,
+  kFewUnique,
+  kZipf
+};
+
+constexpr std::array<BenchDistribution, 6> kBenchDistributions = {
+    BenchDistribution::kRandom,    BenchDistribution::kSorted,    BenchDistribution::kReversed,
+    BenchDistribution::kOrganPipe, BenchDistribution::kFewUnique, BenchDistribution::kZipf};
+
+inline const char *benchDistributionName(BenchDistribution distribution)
+{
+  switch (distribution)
+  {
+    case BenchDistribution::kRandom: return "random";
+    case BenchDistribution::kSorted: return "sorted";
+    case BenchDistribution::kReversed: return "reversed";
+    case BenchDistribution::kOrganPipe: return "organ_pipe";
+    case BenchDistribution::kFewUnique: return "few_unique";
+    case BenchDistribution::kZipf: return "zipf";
+  }
+  return "unknown";
+}
+
+// Distinct ranks of the Zipf distribution
+constexpr std::size_t kBenchZipfSupport = std::size_t(1) << 20;
+// Bits of a rank: every rank is below 2^kBenchRankBits, so 1.0f plus any rank in the bit pattern is still finite
+constexpr unsigned kBenchRankBits = 30;
+
+// n ranks below 2^kBenchRankBits with the given distribution; the same seed gives the same ranks
+inline std::vector<std::uint32_t> generateBenchRanks(std::size_t n, BenchDistribution distribution, std::uint64_t seed = 1)
+{
+  std::vector<std::uint32_t> ranks(n);
+  std::mt19937_64 gen(seed);
+  switch (distribution)
+  {
+    case BenchDistribution::kRandom:
+      for (auto &rank : ranks)
+      {
+        rank = static_cast<std::uint32_t>(gen() >> (64 - kBenchRankBits));
+      }
+      break;
+    case BenchDistribution::kSorted:
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        ranks[i] = static_cast<std::uint32_t>(i);
+      }
+      break;
+    case BenchDistribution::kReversed:
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        ranks[i] = static_cast<std::uint32_t>(n - 1 - i);
+      }
+      break;
+    case BenchDistribution::kOrganPipe:
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        ranks[i] = static_cast<std::uint32_t>(i < n / 2 ? i : n - 1 - i);
+      }
+      break;
+    case BenchDistribution::kFewUnique:
+      for (auto &rank : ranks)
+      {
+        rank = static_cast<std::uint32_t>(gen() % 16);
+      }
+      break;
+    case BenchDistribution::kZipf:
+    {
+      // Inverse-CDF sampling: P(rank r) is proportional to 1 / (r + 1)
+      const std::size_t support = std::max<std::size_t>(1, std::min(n, kBenchZipfSupport));
+      std::vector<double> cumulative(support);
+      double total = 0.0;
+      for (std::size_t r = 0; r < support; ++r)
+      {
+        total += 1.0 / static_cast<double>(r + 1);
+        cumulative[r] = total;
+      }
+      std::uniform_real_distribution<double> uniform(0.0, total);
+      for (auto &rank : ranks)
+      {
+        std::size_t r = std::upper_bound(cumulative.begin(), cumulative.end(), uniform(gen)) - cumulative.begin();
+        r             = std::min(r, support - 1);
+        // Scatter the ranks with an odd multiplier modulo 2^kBenchRankBits
+        rank = static_cast<std::uint32_t>((r * 2654435761u) & ((std::uint64_t(1) << kBenchRankBits) - 1));
+      }
+      break;
+    }
+  }
+  return ranks;
+}
+
+template <typename T>
+std::vector<T> generateBenchKeys(std::size_t n, BenchDistribution distribution, std::uint64_t seed = 1)
+{
+  const std::vector<std::uint32_t> ranks = generateBenchRanks(n, distribution, seed);
+  std::vector<T> keys(n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    if constexpr (std::is_same<T, float>::value)
+    {
+      const std::uint32_t bits = 0x3F800000u + ranks[i];
+      std::memcpy(&keys[i], &bits, sizeof(float));
+    }
+    else { keys[i] = static_cast<T>(ranks[i]); }
+  }
+  return keys;
+}
+
+template <typename T>
+struct BenchTypeName;
+template <>
+struct BenchTypeName<std::int32_t>
+{
+  static constexpr const char *value = "int32";
+};
+template <>
+struct BenchTypeName<std::int64_t>
+{
+  static constexpr const char *value = "int64";
+};
+template <>
+struct BenchTypeName<float>
+{
+  static constexpr const char *value = "float";
+};
+template <>
+struct BenchTypeName<double>
+{
+  static constexpr const char *value = "double";
+};
+
+#endif // SORTING_BENCH_BENCH_DATA_H
@@ -0,0 +1,395 @@
+/*
+Benchmark suite of the sorting module: every algorithm, on sizes 10, 100, ..., up to --bench_max_size (10^8 by
+default), on the distributions of bench_data.h, for int32, int64, float and double keys.
+
+Benchmarks are named group/algorithm/type/distribution/size, e.g. sort/introSort/double/zipf/1000000, so
+--benchmark_filter selects any slice. Items per second is the throughput in keys. The sort and select timings include
+copying the input into the working buffer; sort/copy is that copy alone. JSON for regression tracking:
+
+  sorting_bench --benchmark_out=sorting_bench.json --benchmark_out_format=json
+
+view/ sorts column 1 of a row-major buffer with three columns, either copied out and back or in place through a
+StridedSpan. stream/ replays four jittered sensor streams, 10^3 to 10^7 samples in all, through a StreamSynchronizer.
+external/ runs externalSort on files of 10^6 and 10^7 random doubles in the system temporary directory under 1 GiB,
+16 MiB and 4 MiB budgets; it waits on the disk, so it is timed in wall-clock time.
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sorting/arg_sort/arg_sort.h"
+#include "sorting/bench/bench_data.h"
+#include "sorting/bfprt/bfprt.h"
+#include "sorting/bubble_sort/bubble_sort.h"
+#include "sorting/external_sort/external_sort.h"
+#include "sorting/insert_sort/insert_sort.h"
+#include "sorting/intro_sort/intro_sort.h"
+#include "sorting/make_pair/make_pair.h"
+#include "sorting/merge_vector/merge_vector.h"
+#include "sorting/parallel_sort/parallel_sort.h"
+#include "sorting/power_sort/power_sort.h"
+#include "sorting/quick_sort/quick_sort.h"
+#include "sorting/radix_sort/radix_sort.h"
+#include "sorting/search_index/search_index.h"
+#include "sorting/select_sort/select_sort.h"
+#include "sorting/simd_sort/simd_sort.h"
+#include "sorting/sort_network/sort_network.h"
+#include "sorting/sort_view/sort_view.h"
+#include "sorting/sorted_vector/sorted_vector.h"
+#include "sorting/stream_sync/stream_sync.h"
+
+// Largest size when --bench_max_size is not given
+constexpr std::size_t kBenchDefaultMaxSize = 100000000;
+// O(n^2) algorithms stop at this size
+constexpr std::size_t kBenchQuadraticMaxSize = 10000;
+// Sorted runs merged by the merge benchmarks
+constexpr std::size_t kBenchMergeWays = 8;
+// Columns of the buffer the view benchmarks sort one column of
+constexpr std::size_t kBenchViewColumns = 3;
+// Largest replay of the stream benchmarks, in samples
+constexpr std::size_t kBenchStreamMaxSize = 10000000;
+// Smallest and largest file of the external sort benchmarks, in records
+constexpr std::size_t kBenchExternalMinSize = 1000000;
+constexpr std::size_t kBenchExternalMaxSize = 10000000;
+
+template <typename T>
+using BenchBody = std::function<void(benchmark::State &, const std::vector<T> &)>;
+
+template <typename T>
+void registerBench(const std::string &group, const std::string &algorithm, BenchDistribution distribution,
+                   std::size_t n, BenchBody<T> body)
+{
+  const std::string name = group + "/" + algorithm + "/" + BenchTypeName<T>::value + "/" +
+                           benchDistributionName(distribution) + "/" + std::to_string(n);
+  benchmark::RegisterBenchmark(name.c_str(), [=](benchmark::State &state) {
+    const std::vector<T> input = generateBenchKeys<T>(n, distribution);
+    body(state, input);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * n));
+  });
+}
+
+// Copy the input into a working buffer and run op on it, every iteration
+template <typename T>
+BenchBody<T> inPlaceBody(std::function<void(std::vector<T> &)> op)
+{
+  return [op](benchmark::State &state, const std::vector<T> &input) {
+    std::vector<T> work(input.size());
+    for (auto _ : state)
+    {
+      std::copy(input.begin(), input.end(), work.begin());
+      op(work);
+      benchmark::DoNotOptimize(work.data());
+      benchmark::ClobberMemory();
+    }
+  };
+}
+
+template <typename T>
+void registerSorts(BenchDistribution distribution, std::size_t n)
+{
+  struct Case
+  {
+    const char *name;
+    std::function<void(std::vector<T> &)> sort;
+    std::size_t max_size;
+  };
+  const std::vector<Case> cases = {
+      {"copy", [](std::vector<T> &) {}, kBenchDefaultMaxSize},
+      {"std::sort", [](std::vector<T> &v) { std::sort(v.begin(), v.end()); }, kBenchDefaultMaxSize},
+      {"std::stable_sort", [](std::vector<T> &v) { std::stable_sort(v.begin(), v.end()); }, kBenchDefaultMaxSize},
+      {"bubble", [](std::vector<T> &v) { bubble(v); }, kBenchQuadraticMaxSize},
+      {"insertSort", [](std::vector<T> &v) { insertSort(v); }, kBenchQuadraticMaxSize},
+      {"selectSort", [](std::vector<T> &v) { selectSort(v); }, kBenchQuadraticMaxSize},
+      {"smallSort", [](std::vector<T> &v) { smallSort(v, 0, v.size() - 1); }, kSortNetworkMaxSize},
+      {"quickSort", [](std::vector<T> &v) { quickSort(v, 0, v.size() - 1); }, kBenchDefaultMaxSize},
+      {"introSort", [](std::vector<T> &v) { introSort(v); }, kBenchDefaultMaxSize},
+      {"simdSort", [](std::vector<T> &v) { simdSort(v); }, kBenchDefaultMaxSize},
+      {"parallelSort", [](std::vector<T> &v) { parallelSort(v); }, kBenchDefaultMaxSize},
+      {"radixSort", [](std::vector<T> &v) { radixSort(v); }, kBenchDefaultMaxSize},
+      {"powerSort", [](std::vector<T> &v) { powerSort(v); }, kBenchDefaultMaxSize},
+      {"argSort", [](std::vector<T> &v) { benchmark::DoNotOptimize(argSort(v).data()); }, kBenchDefaultMaxSize},
+      {"SortedVector", [](std::vector<T> &v) {
+         SortedVector<T> sorted;
+         for (const T &key : v)
+         {
+           sorted.insert(key);
+         }
+         benchmark::DoNotOptimize(sorted.size());
+       },
+       kBenchDefaultMaxSize},
+  };
+  for (const Case &c : cases)
+  {
+    if (n <= c.max_size) { registerBench<T>("sort", c.name, distribution, n, inPlaceBody<T>(c.sort)); }
+  }
+}
+
+template <typename T>
+void registerSelections(BenchDistribution distribution, std::size_t n)
+{
+  const std::vector<std::size_t> percentiles = {n / 100, n / 20, n / 4, n / 2, n * 3 / 4, n * 19 / 20, n * 99 / 100};
+  const std::size_t k                        = std::max<std::size_t>(1, n / 100);
+  const std::vector<std::pair<const char *, std::function<void(std::vector<T> &)>>> cases = {
+      {"std::nth_element", [n](std::vector<T> &v) { std::nth_element(v.begin(), v.begin() + n / 2, v.end()); }},
+      {"select", [n](std::vector<T> &v) { benchmark::DoNotOptimize(select(v, 0, n - 1, n / 2)); }},
+      {"nthElement", [n](std::vector<T> &v) { nthElement(v, n / 2); }},
+      {"multiSelect", [percentiles](std::vector<T> &v) { benchmark::DoNotOptimize(multiSelect(v, percentiles).data()); }},
+      {"partialSort", [k](std::vector<T> &v) { partialSort(v, k); }},
+      {"topK", [](std::vector<T> &v) { benchmark::DoNotOptimize(topK(v, 100).data()); }},
+  };
+  for (const auto &c : cases)
+  {
+    registerBench<T>("select", c.first, distribution, n, inPlaceBody<T>(c.second));
+  }
+}
+
+// The input cut into kBenchMergeWays sorted runs
+template <typename T>
+std::vector<std::vector<T>> sortedRuns(const std::vector<T> &input)
+{
+  std::vector<std::vector<T>> runs(kBenchMergeWays);
+  for (std::size_t i = 0; i < kBenchMergeWays; ++i)
+  {
+    runs[i].assign(input.begin() + input.size() * i / kBenchMergeWays,
+                   input.begin() + input.size() * (i + 1) / kBenchMergeWays);
+    std::sort(runs[i].begin(), runs[i].end());
+  }
+  return runs;
+}
+
+template <typename T>
+void registerMerges(BenchDistribution distribution, std::size_t n)
+{
+  registerBench<T>("merge", "mergeSortedVectors", distribution, n, [](benchmark::State &state, const std::vector<T> &input) {
+    const std::vector<std::vector<T>> runs = sortedRuns(input);
+    std::vector<T> out(input.size());
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(mergeSortedVectors(runs, out.begin()));
+    }
+  });
+  registerBench<T>("merge", "parallelMergeSortedVectors", distribution, n,
+                   [](benchmark::State &state, const std::vector<T> &input) {
+                     const std::vector<std::vector<T>> runs = sortedRuns(input);
+                     std::vector<T> out(input.size());
+                     for (auto _ : state)
+                     {
+                       benchmark::DoNotOptimize(parallelMergeSortedVectors(runs, out.begin()));
+                     }
+                   });
+  registerBench<T>("merge", "mergeSortedVectorsN", distribution, n, [](benchmark::State &state, const std::vector<T> &input) {
+    const std::vector<std::vector<T>> runs = sortedRuns(input);
+    std::array<const std::vector<T> *, kBenchMergeWays> pointers;
+    for (std::size_t i = 0; i < kBenchMergeWays; ++i)
+    {
+      pointers[i] = &runs[i];
+    }
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(mergeSortedVectorsN<kBenchMergeWays, T>(pointers).data());
+    }
+  });
+}
+
+template <typename T>
+void registerSearches(BenchDistribution distribution, std::size_t n)
+{
+  // n random probes against the keys
+  registerBench<T>("search", "std::lower_bound", distribution, n, [n](benchmark::State &state, const std::vector<T> &input) {
+    std::vector<T> sorted = input;
+    std::sort(sorted.begin(), sorted.end());
+    const std::vector<T> queries = generateBenchKeys<T>(n, BenchDistribution::kRandom, 2);
+    for (auto _ : state)
+    {
+      std::size_t sum = 0;
+      for (const T &query : queries)
+      {
+        sum += std::lower_bound(sorted.begin(), sorted.end(), query) - sorted.begin();
+      }
+      benchmark::DoNotOptimize(sum);
+    }
+  });
+  registerBench<T>("search", "EytzingerIndex", distribution, n, [n](benchmark::State &state, const std::vector<T> &input) {
+    const EytzingerIndex<T> index(input);
+    const std::vector<T> queries = generateBenchKeys<T>(n, BenchDistribution::kRandom, 2);
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(index.lowerBound(queries).data());
+    }
+  });
+
+  // Pairing two sorted timestamp arrays
+  const auto pairs = [](bool parallel) {
+    return [parallel](benchmark::State &state, const std::vector<T> &input) {
+      std::vector<T> a = input, b = generateBenchKeys<T>(input.size(), BenchDistribution::kRandom, 3);
+      std::sort(a.begin(), a.end());
+      std::sort(b.begin(), b.end());
+      const T threshold = static_cast<T>(1000);
+      for (auto _ : state)
+      {
+        auto result = parallel ? findPairsParallel(a, b, threshold) : findPairsOptimized(a, b, threshold);
+        benchmark::DoNotOptimize(result.data());
+      }
+    };
+  };
+  registerBench<T>("search", "findPairsOptimized", distribution, n, pairs(false));
+  registerBench<T>("search", "findPairsParallel", distribution, n, pairs(true));
+}
+
+template <typename T>
+void registerViews(BenchDistribution distribution, std::size_t n)
+{
+  // The keys go to column 1 of a row-major n x kBenchViewColumns buffer, which is reset every iteration
+  const auto body = [](bool strided) {
+    return [strided](benchmark::State &state, const std::vector<T> &input) {
+      std::vector<T> buffer(input.size() * kBenchViewColumns), column(input.size());
+      for (auto _ : state)
+      {
+        for (std::size_t r = 0; r < input.size(); ++r)
+        {
+          buffer[r * kBenchViewColumns + 1] = input[r];
+        }
+        StridedSpan<T> view(buffer.data() + 1, input.size(), kBenchViewColumns);
+        if (strided) { quickSort(view.begin(), view.end()); }
+        else
+        {
+          std::copy(view.begin(), view.end(), column.begin());
+          quickSort(column.begin(), column.end());
+          std::copy(column.begin(), column.end(), view.begin());
+        }
+        benchmark::DoNotOptimize(buffer.data());
+        benchmark::ClobberMemory();
+      }
+    };
+  };
+  registerBench<T>("view", "copySortCopyBack", distribution, n, body(false));
+  registerBench<T>("view", "StridedSpan", distribution, n, body(true));
+}
+
+// Four sensors at 10, 30, 200 and 20 Hz, each with its own jitter and one sample in 50 dropped, n samples in all,
+// in arrival order as (timestamp, stream)
+inline std::vector<std::pair<double, std::size_t>> sensorArrivals(std::size_t n)
+{
+  const std::array<double, 4> period = {0.1, 1.0 / 30, 0.005, 0.05}, jitter = {0.002, 0.003, 0.0005, 0.004};
+  const double duration = static_cast<double>(n) / 260.0;
+  std::mt19937 gen(2);
+  std::vector<std::pair<double, std::size_t>> arrivals;
+  for (std::size_t j = 0; j < period.size(); ++j)
+  {
+    for (double t = 0.0; t < duration; t += period[j])
+    {
+      if (gen() % 50 == 0) { continue; }
+      arrivals.emplace_back(t + std::uniform_real_distribution<double>(0.0, jitter[j])(gen), j);
+    }
+  }
+  std::sort(arrivals.begin(), arrivals.end());
+  return arrivals;
+}
+
+void registerStreams(std::size_t max_size)
+{
+  for (std::size_t n = 1000; n <= std::min(max_size, kBenchStreamMaxSize); n *= 10)
+  {
+    const std::string name = "stream/StreamSynchronizer/double/sensors/" + std::to_string(n);
+    benchmark::RegisterBenchmark(name.c_str(), [n](benchmark::State &state) {
+      const std::vector<std::pair<double, std::size_t>> arrivals = sensorArrivals(n);
+      for (auto _ : state)
+      {
+        StreamSynchronizer<double, 4> sync(0.004);
+        for (const auto &arrival : arrivals)
+        {
+          sync.push(arrival.second, arrival.first, [](const std::array<double, 4> &tuple) {
+            benchmark::DoNotOptimize(tuple.data());
+          });
+        }
+        benchmark::DoNotOptimize(sync.emitted());
+      }
+      state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * arrivals.size()));
+    });
+  }
+}
+
+void registerExternalSorts(std::size_t max_size)
+{
+  const std::vector<std::pair<const char *, std::size_t>> budgets = {
+      {"externalSort<1GiB>", std::size_t(1) << 30},
+      {"externalSort<16MiB>", std::size_t(16) << 20},
+      {"externalSort<4MiB>", std::size_t(4) << 20},
+  };
+  for (std::size_t n = kBenchExternalMinSize; n <= std::min(max_size, kBenchExternalMaxSize); n *= 10)
+  {
+    for (const auto &budget : budgets)
+    {
+      const std::string name = std::string("external/") + budget.first + "/double/random/" + std::to_string(n);
+      const std::size_t memory_budget = budget.second;
+      benchmark::RegisterBenchmark(name.c_str(), [n, memory_budget](benchmark::State &state) {
+        const auto directory = std::filesystem::temp_directory_path();
+        const std::string in = (directory / "sorting_bench_in").string(), out = (directory / "sorting_bench_out").string();
+        const std::vector<double> input = generateBenchKeys<double>(n, BenchDistribution::kRandom);
+        writeRecords(in, input.data(), n);
+        ExternalSortOptions options;
+        options.memory_budget = memory_budget;
+        for (auto _ : state)
+        {
+          benchmark::DoNotOptimize(externalSort<double>(in, out, options));
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * n));
+        std::filesystem::remove(in);
+        std::filesystem::remove(out);
+      })->UseRealTime();
+    }
+  }
+}
+
+template <typename T>
+void registerAll(std::size_t max_size)
+{
+  for (BenchDistribution distribution : kBenchDistributions)
+  {
+    for (std::size_t n = 10; n <= max_size; n *= 10)
+    {
+      registerSorts<T>(distribution, n);
+      registerSelections<T>(distribution, n);
+      registerMerges<T>(distribution, n);
+      registerSearches<T>(distribution, n);
+      registerViews<T>(distribution, n);
+    }
+  }
+}
+
+int main(int argc, char **argv)
+{
+  // Take --bench_max_size=N out of the arguments before Google Benchmark parses them
+  std::size_t max_size = kBenchDefaultMaxSize;
+  int kept             = 1;
+  for (int i = 1; i < argc; ++i)
+  {
+    const char *flag = "--bench_max_size=";
+    if (std::strncmp(argv[i], flag, std::strlen(flag)) == 0) { max_size = std::strtoull(argv[i] + std::strlen(flag), nullptr, 10); }
+    else { argv[kept++] = argv[i]; }
+  }
+  argc = kept;
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) { return 1; }
+  registerAll<std::int32_t>(max_size);
+  registerAll<std::int64_t>(max_size);
+  registerAll<float>(max_size);
+  registerAll<double>(max_size);
+  registerStreams(max_size);
+  registerExternalSorts(max_size);
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
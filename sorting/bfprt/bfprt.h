@@ -1,76 +1,262 @@
 
 #include <algorithm>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "sorting/insert_sort/insert_sort.h"
+#include "sorting/intro_sort/intro_sort.h"
+#include "sorting/simd_sort/simd_sort.h"
+#include "sorting/sort_network/sort_network.h"
+#include "sorting/sort_view/sort_view.h"
+
 #ifndef SORTING_BFPRT_BFPRT_H
 #define SORTING_BFPRT_BFPRT_H
 
-template <typename T>
-std::size_t partition(std::vector<T> &arr, std::size_t left, std::size_t right, std::size_t pivot_index)
+// Partitions that keep more than 3/4 of the range an introselect tolerates before it switches to median-of-medians
+// pivots. The good partitions shrink the range geometrically and each bad one costs at most n, so a constant budget
+// keeps the total work linear; a budget of log2(n) would allow O(n log n).
+constexpr std::size_t kIntroSelectBadPartitions = 4;
+
+template <typename RandomIt, typename Less>
+void selectRange(RandomIt first, RandomIt nth, RandomIt last, Less &less,
+                 std::size_t bad_partitions = kIntroSelectBadPartitions);
+
+// Return the median of the medians of the groups of five of [first, last), moved to the front of the range. For
+// distinct keys it lies between the 30th and 70th percentile.
+template <typename RandomIt, typename Less>
+RandomIt medianOfMediansRange(RandomIt first, RandomIt last, Less &less)
 {
-  T pivot_value = arr[pivot_index];
-  std::swap(arr[pivot_index], arr[right]); // Move pivot to end
-  std::size_t store_index = left;
-  for (std::size_t i = left; i < right; i++)
+  RandomIt store = first;
+  for (RandomIt group = first; group != last;)
   {
-    if (arr[i] < pivot_value)
+    RandomIt group_last = last - group > 5 ? group + 5 : last;
+    if constexpr (std::is_same<Less, PlainLess>::value && IsContiguousIterator<RandomIt>::value)
     {
-      std::swap(arr[i], arr[store_index]);
-      store_index++;
+      if (group_last - group == 5) { medianNetwork<5>(&*group); }
+      else { smallSort(group, group_last, less); }
     }
+    else { smallSort(group, group_last, less); }
+    std::iter_swap(store++, group + (group_last - group - 1) / 2);
+    group = group_last;
   }
-  std::swap(arr[store_index], arr[right]); // Move pivot to its final place
-  return store_index;
-}
 
-template <typename T>
-T select(std::vector<T> &arr, std::size_t left, std::size_t right, std::size_t k);
+  // Now find the median of medians with selection, which leaves it at mid
+  RandomIt mid = first + (store - first - 1) / 2;
+  selectRange(first, mid, store, less);
+  return mid;
+}
 
-template <typename T>
-T medianOfMedians(std::vector<T> &arr, std::size_t left, std::size_t right)
+// One selection step: partition [first, last) around *pivot and return the range of keys equal to it, which are in
+// their final place. Everything before that range is not greater than the pivot and everything after it is not less;
+// both outer parts are strictly shorter than [first, last).
+template <typename RandomIt, typename Less>
+std::pair<RandomIt, RandomIt> selectionPartition(RandomIt first, RandomIt last, RandomIt pivot, Less &less)
 {
-  // Base case: if the array is small enough, return the median directly
-  if (right - left + 1 <= 5)
+  using T = typename std::iterator_traits<RandomIt>::value_type;
+  if constexpr (SimdSortSupported<T>::value && std::is_same<Less, PlainLess>::value &&
+                IsContiguousIterator<RandomIt>::value)
   {
-    std::sort(arr.begin() + left, arr.begin() + right + 1);
-    return arr[left + (right - left) / 2];
+    // Primitive keys: vectorized two-way partition; keys equal to the pivot are split off once it is the minimum
+    const std::size_t n    = static_cast<std::size_t>(last - first);
+    const T value          = *pivot;
+    RandomIt less_end      = first + simdPartition(&*first, n, value);
+    RandomIt greater_begin = less_end;
+    if (less_end == first)
+    {
+      greater_begin = first + simdPartition(&*first, n, value, true);
+      if (greater_begin == first)
+      {
+        heapSort(first, last, less); // unordered keys such as NaN
+        greater_begin = last;
+      }
+    }
+    return {less_end, greater_begin};
+  }
+  else
+  {
+    std::iter_swap(first, pivot);
+    return fatPartition(first, last, less);
   }
+}
 
-  // Recursively find the median of all groups of five
-  for (std::size_t i = left; i <= right; i += 5)
+// The selection engine behind select, nthElement and multiSelect: rearrange [first, last) so that *nth is the element
+// a full sort by less would put there. Ninther or median-of-three pivots while partitions go well, median-of-medians
+// pivots after bad_partitions bad ones; a budget of 0 is plain BFPRT.
+template <typename RandomIt, typename Less>
+void selectRange(RandomIt first, RandomIt nth, RandomIt last, Less &less, std::size_t bad_partitions)
+{
+  const auto threshold = static_cast<std::ptrdiff_t>(kIntroSortInsertionThreshold);
+  while (last - first > threshold)
   {
-    std::size_t sub_right = i + 4;
-    if (sub_right > right) sub_right = right;
-    auto median = medianOfMedians(arr, i, sub_right);
-    std::swap(arr[left + (i - left) / 5], median); // Store median of each block at start of array
+    const auto n   = last - first;
+    RandomIt pivot = bad_partitions > 0 ? choosePivot(first, last, less) : medianOfMediansRange(first, last, less);
+    auto equal     = selectionPartition(first, last, pivot, less);
+    if (nth < equal.first) { last = equal.first; }
+    else if (!(nth < equal.second)) { first = equal.second; }
+    else { return; }
+
+    if (last - first > n / 4 * 3 && bad_partitions > 0) { bad_partitions--; }
   }
+  smallSort(first, last, less);
+}
 
-  // Now find the median of medians using the select algorithm
-  int mid = (right - left) / 10 + left + 1;
-  return select(arr, left, left + (right - left) / 5, mid);
+// Iterator form of select for memory the caller owns: rearrange [first, last) so that *nth is the element a full sort
+// by comp(proj(a), proj(b)) would put there, nothing before it greater and nothing after it less. Expected O(n) with
+// ninther pivots, worst case O(n) through the median-of-medians fallback.
+template <typename RandomIt, typename Compare = std::less<>, typename Projection = SortIdentity>
+void select(RandomIt first, RandomIt nth, RandomIt last, Compare comp = Compare(), Projection proj = Projection())
+{
+  if (!(nth < last)) { return; }
+  auto less = projectedCompare(std::move(comp), std::move(proj));
+  selectRange(first, nth, last, less);
 }
 
+// BFPRT: the k-th smallest element of the closed range [left, right], with a median-of-medians pivot on every round.
+// Worst case O(n); arr is rearranged as by nthElement.
 template <typename T>
 T select(std::vector<T> &arr, std::size_t left, std::size_t right, std::size_t k)
 {
-  while (true)
+  PlainLess less;
+  selectRange(arr.begin() + left, arr.begin() + k, arr.begin() + right + 1, less, 0);
+  return arr[k];
+}
+
+/*
+Introselect: quickselect with median-of-three/ninther pivots and three-way partitioning (the vectorized partition of
+simd_sort.h for primitive keys), which switches to median-of-medians pivots once partitions keep going badly.
+Expected O(n) with a small constant, worst case O(n).
+*/
+
+// Rearrange [left, right] so that arr[k] is the element a full sort would put there, everything before it is not
+// greater and everything after it is not less (like std::nth_element)
+template <typename T>
+void nthElement(std::vector<T> &arr, std::size_t left, std::size_t right, std::size_t k)
+{
+  if (left >= right || k < left || k > right) { return; }
+
+  PlainLess less;
+  selectRange(arr.begin() + left, arr.begin() + k, arr.begin() + right + 1, less);
+}
+
+template <typename T>
+void nthElement(std::vector<T> &arr, std::size_t k)
+{
+  if (arr.empty()) { return; }
+  nthElement(arr, 0, arr.size() - 1, k);
+}
+
+// Same contract as select(), but expected linear time with a much smaller constant
+template <typename T>
+T introSelect(std::vector<T> &arr, std::size_t left, std::size_t right, std::size_t k)
+{
+  nthElement(arr, left, right, k);
+  return arr[k];
+}
+
+/*
+Multi-select: place several ranks at once. The range is partitioned once and only the sub-ranges that still contain a
+requested rank are partitioned further, so m ranks cost about O(n log m) instead of m separate selections.
+*/
+
+// Rearrange arr so that arr[r] is the element a full sort would put there for every r in ranks, and return those
+// elements in the order of ranks, so result[i] is always the element of rank ranks[i]. Throws std::out_of_range if a
+// rank is not below arr.size(); arr is then left unchanged.
+template <typename T>
+std::vector<T> multiSelect(std::vector<T> &arr, const std::vector<std::size_t> &ranks)
+{
+  for (std::size_t r : ranks)
   {
-    if (left == right) { return arr[left]; }
-    std::size_t pivot_index = medianOfMedians(arr, left, right);
-    pivot_index             = partition(arr, left, right, pivot_index);
-    if (k == pivot_index)
+    if (r >= arr.size()) { throw std::out_of_range("multiSelect: rank " + std::to_string(r) + " is not below the array size"); }
+  }
+  std::vector<std::size_t> sorted_ranks = ranks;
+  std::sort(sorted_ranks.begin(), sorted_ranks.end());
+  sorted_ranks.erase(std::unique(sorted_ranks.begin(), sorted_ranks.end()), sorted_ranks.end());
+
+  PlainLess less;
+  struct Task
+  {
+    std::size_t left, right;           // closed range of the array
+    std::size_t rank_first, rank_last; // half-open range of sorted_ranks inside [left, right]
+    std::size_t bad_partitions;
+  };
+  std::vector<Task> stack;
+  if (!sorted_ranks.empty()) { stack.push_back({0, arr.size() - 1, 0, sorted_ranks.size(), kIntroSelectBadPartitions}); }
+
+  while (!stack.empty())
+  {
+    Task task = stack.back();
+    stack.pop_back();
+
+    auto first = arr.begin() + task.left, last = arr.begin() + task.right + 1;
+    if (task.rank_last - task.rank_first == 1)
     {
-      return arr[k];
+      selectRange(first, arr.begin() + sorted_ranks[task.rank_first], last, less, task.bad_partitions);
+      continue;
     }
-    else if (k < pivot_index)
+    if (task.right - task.left + 1 <= kIntroSortInsertionThreshold)
     {
-      right = pivot_index - 1;
+      smallSort(first, last, less);
+      continue;
     }
-    else
+
+    std::size_t n = task.right - task.left + 1;
+    auto pivot    = task.bad_partitions > 0 ? choosePivot(first, last, less) : medianOfMediansRange(first, last, less);
+    auto equal    = selectionPartition(first, last, pivot, less);
+    std::size_t less_end      = static_cast<std::size_t>(equal.first - arr.begin());
+    std::size_t greater_begin = static_cast<std::size_t>(equal.second - arr.begin());
+
+    auto ranks_begin          = sorted_ranks.begin();
+    std::size_t less_last     = std::lower_bound(ranks_begin + task.rank_first, ranks_begin + task.rank_last, less_end) - ranks_begin;
+    std::size_t greater_first = std::lower_bound(ranks_begin + less_last, ranks_begin + task.rank_last, greater_begin) - ranks_begin;
+
+    if (less_last > task.rank_first)
+    {
+      std::size_t bad = task.bad_partitions - (less_end - task.left > n / 4 * 3 && task.bad_partitions > 0 ? 1 : 0);
+      stack.push_back({task.left, less_end - 1, task.rank_first, less_last, bad});
+    }
+    if (task.rank_last > greater_first)
     {
-      left = pivot_index + 1;
+      std::size_t bad = task.bad_partitions - (task.right + 1 - greater_begin > n / 4 * 3 && task.bad_partitions > 0 ? 1 : 0);
+      stack.push_back({greater_begin, task.right, greater_first, task.rank_last, bad});
     }
   }
+
+  std::vector<T> values;
+  values.reserve(ranks.size());
+  for (std::size_t r : ranks)
+  {
+    values.push_back(arr[r]);
+  }
+  return values;
+}
+
+// Sort the k smallest elements into [0, k); the order of the rest is unspecified. O(n + k log k)
+template <typename T>
+void partialSort(std::vector<T> &arr, std::size_t k)
+{
+  k = std::min(k, arr.size());
+  if (k == 0) { return; }
+  if (k < arr.size()) { nthElement(arr, k); }
+  introSort(arr, 0, k - 1);
+}
+
+// Return the k largest elements, largest first. arr is reordered. O(n + k log k)
+template <typename T>
+std::vector<T> topK(std::vector<T> &arr, std::size_t k)
+{
+  k = std::min(k, arr.size());
+  if (k == 0) { return {}; }
+  std::size_t first = arr.size() - k;
+  nthElement(arr, first);
+  std::vector<T> top(arr.begin() + first, arr.end());
+  introSort(top);
+  std::reverse(top.begin(), top.end());
+  return top;
 }
 
 #endif // SORTING_BFPRT_BFPRT_H
\ No newline at end of file
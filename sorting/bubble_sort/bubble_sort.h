@@ -1,6 +1,10 @@
 
+#include <algorithm>
+#include <functional>
 #include <vector>
 
+#include "sorting/sort_view/sort_view.h"
+
 #ifndef SORTING_BUBBLE_SORT_BUBBLE_SORT_H
 #define SORTING_BUBBLE_SORT_BUBBLE_SORT_H
 
@@ -13,22 +17,27 @@
 |Slow |on large lists or large data sets|
 */
 
-template <typename T>
-void bubble(std::vector<T> &a) // 冒泡排序
+// Sort [first, last) of any random-access range by comp(proj(a), proj(b))
+template <typename RandomIt, typename Compare = std::less<>, typename Projection = SortIdentity>
+void bubble(RandomIt first, RandomIt last, Compare comp = Compare(), Projection proj = Projection())
 {
-  int temp;                              // 临时变量
-  for (int i = 0; i < a.size() - 1; i++) // 元素比较界限
+  auto less = projectedCompare(std::move(comp), std::move(proj));
+  for (RandomIt end = last; end - first > 1; --end) // 元素比较界限
   {
-    for (int j = 0; j < a.size() - 1 - i; j++) // 该元素与加1位置元素比较
+    for (RandomIt j = first; j + 1 != end; ++j) // 该元素与加1位置元素比较
     {
-      if (a[j] > a[j + 1]) // 把大元素放到位置右
+      if (less(*(j + 1), *j)) // 把大元素放到位置右
       {
-        temp     = a[j]; // 元素交换
-        a[j]     = a[j + 1];
-        a[j + 1] = temp;
+        std::iter_swap(j, j + 1); // 元素交换
       }
     }
   }
 }
 
+template <typename T>
+void bubble(std::vector<T> &a) // 冒泡排序
+{
+  bubble(a.begin(), a.end());
+}
+
 #endif // SORTING_BUBBLE_SORT_BUBBLE_SORT_H
\ No newline at end of file
@@ -0,0 +1,2 @@
+
+#include "sorting/external_sort/external_sort.h"
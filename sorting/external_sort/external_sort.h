@@ -0,0 +1,350 @@
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <future>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "sorting/merge_vector/merge_vector.h"
+#include "sorting/simd_sort/simd_sort.h"
+
+#ifndef SORTING_EXTERNAL_SORT_H
+#define SORTING_EXTERNAL_SORT_H
+
+/*
+External merge sort for binary files of fixed-size records that do not fit in memory.
+1. Run generation: the input is memory-mapped and cut into chunks of half the memory budget. Each chunk is copied
+   out and sorted with `simdSort`, then written to a run file on a background thread while the next chunk is copied
+   and sorted. `madvise(MADV_WILLNEED)` asks the kernel to start reading the next chunk before the current one is
+   sorted.
+2. Merge: the runs are memory-mapped with sequential read-ahead and merged by the `LoserTree` from merge_vector.h
+   into a double-buffered writer, which writes one block on a background thread while the other fills. More than
+   `max_fan_in` runs are merged in several passes.
+
+Input, run and output files share one format: the raw bytes of consecutive records, with no header. The record
+count is the file size divided by sizeof(T).
+
+|property|description|
+|---|---|
+|I/O|every pass reads and writes the data once: two passes up to about `memory_budget / 2 * max_fan_in` bytes.|
+|Memory|record buffers stay within `memory_budget`; mapped pages are clean page cache that the kernel reclaims.|
+|Records|any trivially copyable T ordered by operator<.|
+|Disk|the runs need as much temporary space as the input.|
+|Not Stable|it does not preserve the relative order of equal records.|
+*/
+
+struct ExternalSortOptions
+{
+  // Bytes of record buffers: half holds the chunk being sorted, half the run being written
+  std::size_t memory_budget = std::size_t(256) << 20;
+  // Runs merged at once; more runs are merged in several passes
+  std::size_t max_fan_in = 256;
+  // Directory for run files; empty uses the system temporary directory
+  std::string temp_dir;
+};
+
+[[noreturn]] inline void externalSortError(const std::string &what)
+{
+  throw std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+// Read-only memory map of a whole file
+class MappedFile
+{
+ public:
+  explicit MappedFile(const std::string &path)
+  {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) { externalSortError("cannot open " + path); }
+    struct stat status;
+    if (::fstat(fd, &status) != 0)
+    {
+      ::close(fd);
+      externalSortError("cannot stat " + path);
+    }
+    size_ = static_cast<std::size_t>(status.st_size);
+    if (size_ > 0)
+    {
+      void *data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED)
+      {
+        ::close(fd);
+        externalSortError("cannot map " + path);
+      }
+      data_ = static_cast<char *>(data);
+    }
+    ::close(fd);
+  }
+
+  MappedFile(MappedFile &&other) noexcept : data_(std::exchange(other.data_, nullptr)), size_(other.size_) {}
+  MappedFile(const MappedFile &)            = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  MappedFile &operator=(MappedFile &&)      = delete;
+
+  ~MappedFile()
+  {
+    if (data_ != nullptr) { ::munmap(data_, size_); }
+  }
+
+  const char *data() const { return data_; }
+  std::size_t size() const { return size_; }
+
+  // A hint only, so failures are ignored
+  void advise(std::size_t offset, std::size_t length, int advice) const
+  {
+    if (data_ == nullptr || length == 0) { return; }
+    const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    std::size_t begin      = offset / page * page;
+    ::madvise(data_ + begin, offset + length - begin, advice);
+  }
+
+ private:
+  char *data_       = nullptr;
+  std::size_t size_ = 0;
+};
+
+inline void writeAll(int fd, const char *data, std::size_t bytes, const std::string &path)
+{
+  while (bytes > 0)
+  {
+    ssize_t written = ::write(fd, data, bytes);
+    if (written < 0)
+    {
+      if (errno == EINTR) { continue; }
+      externalSortError("cannot write " + path);
+    }
+    data += written;
+    bytes -= static_cast<std::size_t>(written);
+  }
+}
+
+inline int createFile(const std::string &path)
+{
+  int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) { externalSortError("cannot create " + path); }
+  return fd;
+}
+
+template <typename T>
+void writeRecords(const std::string &path, const T *records, std::size_t count)
+{
+  int fd = createFile(path);
+  try
+  {
+    writeAll(fd, reinterpret_cast<const char *>(records), count * sizeof(T), path);
+  }
+  catch (...)
+  {
+    ::close(fd);
+    throw;
+  }
+  if (::close(fd) != 0) { externalSortError("cannot close " + path); }
+}
+
+// Buffered record writer with two blocks: one is written on a background thread while the other fills.
+// std::back_inserter(writer) is an output iterator for LoserTree::drain.
+template <typename T>
+class ExternalRunWriter
+{
+ public:
+  using value_type = T;
+
+  ExternalRunWriter(const std::string &path, std::size_t block_records) :
+    path_(path), fd_(createFile(path)), block_(std::max<std::size_t>(1, block_records))
+  {
+    active_.reserve(block_);
+    pending_.reserve(block_);
+  }
+
+  ExternalRunWriter(const ExternalRunWriter &)            = delete;
+  ExternalRunWriter &operator=(const ExternalRunWriter &) = delete;
+
+  ~ExternalRunWriter()
+  {
+    if (write_.valid()) { write_.wait(); }
+    if (fd_ >= 0) { ::close(fd_); }
+  }
+
+  void push_back(const T &record)
+  {
+    active_.push_back(record);
+    if (active_.size() == block_) { flush(); }
+  }
+
+  // Write the remaining records and close the file; errors from the background writes surface here
+  void close()
+  {
+    flush();
+    wait();
+    int fd = std::exchange(fd_, -1);
+    if (::close(fd) != 0) { externalSortError("cannot close " + path_); }
+  }
+
+ private:
+  void wait()
+  {
+    if (write_.valid()) { write_.get(); }
+  }
+
+  void flush()
+  {
+    wait();
+    std::swap(active_, pending_);
+    active_.clear();
+    if (pending_.empty()) { return; }
+    write_ = std::async(std::launch::async, [this]() {
+      writeAll(fd_, reinterpret_cast<const char *>(pending_.data()), pending_.size() * sizeof(T), path_);
+    });
+  }
+
+  std::string path_;
+  int fd_;
+  std::size_t block_;
+  std::vector<T> active_, pending_;
+  std::future<void> write_;
+};
+
+// Temporary run files, removed when the set is destroyed
+class ExternalRunFiles
+{
+ public:
+  explicit ExternalRunFiles(std::filesystem::path directory) : directory_(std::move(directory)) {}
+  ExternalRunFiles(const ExternalRunFiles &)            = delete;
+  ExternalRunFiles &operator=(const ExternalRunFiles &) = delete;
+
+  ~ExternalRunFiles()
+  {
+    std::error_code ignored;
+    for (const auto &path : paths_)
+    {
+      if (!path.empty()) { std::filesystem::remove(path, ignored); }
+    }
+  }
+
+  const std::string &add()
+  {
+    static std::atomic<std::size_t> counter{0};
+    std::string name = "bmath_sort_" + std::to_string(::getpid()) + "_" + std::to_string(counter++) + ".run";
+    paths_.push_back((directory_ / name).string());
+    return paths_.back();
+  }
+
+  // Hand a run over to another set without copying the file
+  void transfer(std::size_t i, ExternalRunFiles &to)
+  {
+    to.paths_.push_back(std::move(paths_[i]));
+    paths_[i].clear();
+  }
+
+  void swap(ExternalRunFiles &other)
+  {
+    std::swap(directory_, other.directory_);
+    std::swap(paths_, other.paths_);
+  }
+
+  std::size_t size() const { return paths_.size(); }
+  const std::string &operator[](std::size_t i) const { return paths_[i]; }
+
+ private:
+  std::filesystem::path directory_;
+  std::vector<std::string> paths_;
+};
+
+template <typename T>
+void mergeExternalRuns(const ExternalRunFiles &runs, std::size_t first, std::size_t last, const std::string &output_path,
+                       std::size_t block_records)
+{
+  std::vector<MappedFile> files;
+  std::vector<std::pair<const T *, const T *>> ranges;
+  files.reserve(last - first);
+  ranges.reserve(last - first);
+  for (std::size_t i = first; i < last; ++i)
+  {
+    files.emplace_back(runs[i]);
+    files.back().advise(0, files.back().size(), MADV_SEQUENTIAL);
+    const T *records = reinterpret_cast<const T *>(files.back().data());
+    ranges.emplace_back(records, records + files.back().size() / sizeof(T));
+  }
+
+  ExternalRunWriter<T> writer(output_path, block_records);
+  LoserTree<const T *>(std::move(ranges)).drain(std::back_inserter(writer));
+  writer.close();
+}
+
+// Sort the records of input_path into output_path (which must be a different file) and return the number of
+// initial runs. Throws std::runtime_error on I/O errors; run files are removed either way.
+template <typename T>
+std::size_t externalSort(const std::string &input_path, const std::string &output_path,
+                         const ExternalSortOptions &options = ExternalSortOptions())
+{
+  static_assert(std::is_trivially_copyable<T>::value, "external sort records must be trivially copyable");
+
+  MappedFile input(input_path);
+  if (input.size() % sizeof(T) != 0) { throw std::runtime_error(input_path + ": size is not a multiple of the record size"); }
+  const std::size_t n     = input.size() / sizeof(T);
+  const std::size_t chunk = std::max<std::size_t>(1, options.memory_budget / 2 / sizeof(T));
+  const T *records        = reinterpret_cast<const T *>(input.data());
+
+  const std::filesystem::path temp_dir =
+      options.temp_dir.empty() ? std::filesystem::temp_directory_path() : std::filesystem::path(options.temp_dir);
+  ExternalRunFiles runs(temp_dir);
+  if (n == 0)
+  {
+    writeRecords<T>(output_path, nullptr, 0);
+    return 0;
+  }
+
+  // Run generation: copy and sort one chunk while the previous run is written
+  input.advise(0, input.size(), MADV_SEQUENTIAL);
+  std::vector<T> sorting, writing;
+  std::future<void> write;
+  for (std::size_t begin = 0; begin < n; begin += chunk)
+  {
+    std::size_t end = std::min(n, begin + chunk);
+    if (end < n) { input.advise(end * sizeof(T), (std::min(n, end + chunk) - end) * sizeof(T), MADV_WILLNEED); }
+
+    sorting.assign(records + begin, records + end);
+    simdSort(sorting);
+
+    if (write.valid()) { write.get(); }
+    std::swap(sorting, writing);
+    std::string path = n <= chunk ? output_path : runs.add();
+    write = std::async(std::launch::async, [&writing, path]() { writeRecords(path, writing.data(), writing.size()); });
+  }
+  write.get();
+  const std::size_t initial_runs = n <= chunk ? 1 : runs.size();
+  std::vector<T>().swap(sorting);
+  std::vector<T>().swap(writing);
+
+  // Merge passes; the writer's two blocks use half the budget
+  const std::size_t fan_in = std::max<std::size_t>(2, options.max_fan_in);
+  const std::size_t block  = std::max<std::size_t>(1, options.memory_budget / 4 / sizeof(T));
+  while (runs.size() > 0)
+  {
+    const bool final_pass = runs.size() <= fan_in;
+    ExternalRunFiles next(temp_dir);
+    for (std::size_t first = 0; first < runs.size(); first += fan_in)
+    {
+      std::size_t last = std::min(runs.size(), first + fan_in);
+      if (last - first == 1 && !final_pass) { runs.transfer(first, next); }
+      else { mergeExternalRuns<T>(runs, first, last, final_pass ? output_path : next.add(), block); }
+    }
+    if (final_pass) { break; }
+    runs.swap(next); // the merged runs are removed with next
+  }
+  return initial_runs;
+}
+
+#endif // SORTING_EXTERNAL_SORT_H
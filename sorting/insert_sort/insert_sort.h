@@ -1,6 +1,10 @@
 
+#include <functional>
+#include <utility>
 #include <vector>
 
+#include "sorting/sort_view/sort_view.h"
+
 #ifndef SORTING_INSERT_SORT_H
 #define SORTING_INSERT_SORT_H
 
@@ -12,20 +16,36 @@
 |Online Sorting|insertion sort can be used to sort data as it is received, which is useful for real-time applications.|
 */
 
-template <typename T>
-void insertSort(std::vector<T> &a)
+// Sort [first, last) of any random-access range by comp(proj(a), proj(b))
+template <typename RandomIt, typename Compare = std::less<>, typename Projection = SortIdentity>
+void insertSort(RandomIt first, RandomIt last, Compare comp = Compare(), Projection proj = Projection())
 {
-  int temp; // 临时变量
-  int i, j; // 循环变量
-  for (i = 1; i < a.size(); i++)
+  auto less = projectedCompare(std::move(comp), std::move(proj));
+  if (last - first < 2) { return; }
+  for (RandomIt i = first + 1; i != last; ++i)
   {
-    temp = a[i];                               // 获取比较值
-    for (j = i; j > 0 && a[j - 1] > temp; j--) // 前i个元素,如果有大元素交换
+    auto temp  = std::move(*i); // 获取比较值
+    RandomIt j = i;             // 循环变量
+    for (; j != first && less(temp, *(j - 1)); --j) // 前i个元素,如果有大元素交换
     {
-      a[j] = a[j - 1]; // 移到当前位置
+      *j = std::move(*(j - 1)); // 移到当前位置
     }
-    a[j] = temp; // 将最后一个交换的j位置元素赋值temp
+    *j = std::move(temp); // 将最后一个交换的j位置元素赋值temp
   }
 }
 
+// Sort the closed range [low, high] of the array. Used as the small-subarray cutoff of other sorts.
+template <typename T>
+void insertSort(std::vector<T> &a, std::size_t low, std::size_t high)
+{
+  if (high <= low) { return; }
+  insertSort(a.begin() + low, a.begin() + high + 1);
+}
+
+template <typename T>
+void insertSort(std::vector<T> &a)
+{
+  insertSort(a.begin(), a.end());
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,2 @@
+
+#include "sorting/intro_sort/intro_sort.h"
@@ -0,0 +1,211 @@
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "sorting/sort_network/sort_network.h"
+#include "sorting/sort_view/sort_view.h"
+
+#ifndef SORTING_INTRO_SORT_H
+#define SORTING_INTRO_SORT_H
+
+/*
+|property|description|
+|---|---|
+|Time Complexity|best case: O(n) (all keys equal), average case: O(n log n), worst case: O(n log n)|
+|Space Complexity|O(log n): iterative, the smaller partition is always processed first so the explicit stack stays logarithmic.|
+|Duplicate Keys|three-way (fat) partitioning groups keys equal to the pivot, so duplicate-heavy inputs do not degrade.|
+|Pivot|median-of-three for short ranges, ninther (median of three medians) for long ranges; sorted and reversed inputs stay fast.|
+|Adaptable|small sub-arrays are finished by `smallSort`: a branchless sorting network for arithmetic keys, insertion sort otherwise.|
+|Worst-Case Guard|falls back to heapsort once the partition depth exceeds 2 log2(n).|
+|Iterators|`introSort(first, last, comp, proj)` sorts any random-access range; the std::vector overloads and `quickSort` forward to the same engine, `introSortRange`.|
+|Not Stable|it does not preserve the relative order of equal elements.|
+*/
+
+// Sub-arrays with at most this many elements are finished by `smallSort`
+constexpr std::size_t kIntroSortInsertionThreshold = 16;
+// Sub-arrays longer than this use the ninther instead of median-of-three
+constexpr std::size_t kIntroSortNintherThreshold = 128;
+
+// Return the iterator to the median of *a, *b, *c
+template <typename RandomIt, typename Less>
+RandomIt medianOfThree(RandomIt a, RandomIt b, RandomIt c, Less &less)
+{
+  if (less(*a, *b))
+  {
+    if (less(*b, *c)) { return b; }
+    return less(*a, *c) ? c : a;
+  }
+  if (less(*a, *c)) { return a; }
+  return less(*b, *c) ? c : b;
+}
+
+// Choose a pivot for [first, last) and return its position
+template <typename RandomIt, typename Less>
+RandomIt choosePivot(RandomIt first, RandomIt last, Less &less)
+{
+  const auto n    = last - first;
+  RandomIt mid    = first + n / 2;
+  RandomIt high   = last - 1;
+  if (n > static_cast<std::ptrdiff_t>(kIntroSortNintherThreshold))
+  {
+    // Tukey's ninther: median of the medians of three evenly spaced triples
+    const auto step = n / 8;
+    RandomIt m1     = medianOfThree(first, first + step, first + 2 * step, less);
+    RandomIt m2     = medianOfThree(mid - step, mid, mid + step, less);
+    RandomIt m3     = medianOfThree(high - 2 * step, high - step, high, less);
+    return medianOfThree(m1, m2, m3, less);
+  }
+  return medianOfThree(first, mid, high, less);
+}
+
+template <typename T>
+std::size_t choosePivot(const std::vector<T> &arr, std::size_t low, std::size_t high)
+{
+  PlainLess less;
+  return static_cast<std::size_t>(choosePivot(arr.begin() + low, arr.begin() + high + 1, less) - arr.begin());
+}
+
+// Bentley-McIlroy three-way partition of [first, last) around *first. Returns the range of keys equivalent to the
+// pivot: everything before it is less and everything after it is greater.
+template <typename RandomIt, typename Less>
+std::pair<RandomIt, RandomIt> fatPartition(RandomIt first, RandomIt last, Less &less)
+{
+  const auto &pivot = *first; // never moved while scanning: all swaps stay inside (first, last)
+
+  // Keys equal to the pivot are parked at both ends: [first, a) and (d, last)
+  RandomIt a = first + 1, b = first + 1;
+  RandomIt c = last - 1, d = last - 1;
+  while (true)
+  {
+    while (b <= c && !less(pivot, *b))
+    {
+      if (!less(*b, pivot)) { std::iter_swap(a++, b); }
+      ++b;
+    }
+    while (b <= c && !less(*c, pivot))
+    {
+      if (!less(pivot, *c)) { std::iter_swap(c, d--); }
+      --c;
+    }
+    if (b > c) { break; }
+    std::iter_swap(b++, c--);
+  }
+
+  // Now [a, b) < pivot and [b, d] > pivot; move the parked equal keys to the middle
+  const auto less_count    = b - a;
+  const auto greater_count = d - b + 1;
+  auto s                   = std::min(a - first, less_count);
+  std::swap_ranges(first, first + s, b - s);
+  s = std::min(greater_count, last - 1 - d);
+  std::swap_ranges(b, b + s, last - s);
+
+  return {first + less_count, last - greater_count};
+}
+
+// Heapsort of [first, last); the depth-limit fallback of introSortRange
+template <typename RandomIt, typename Less>
+void heapSort(RandomIt first, RandomIt last, Less &less)
+{
+  std::make_heap(first, last, std::ref(less));
+  std::sort_heap(first, last, std::ref(less));
+}
+
+// Heapsort of the closed range [low, high]
+template <typename T>
+void heapSort(std::vector<T> &arr, std::size_t low, std::size_t high)
+{
+  PlainLess less;
+  heapSort(arr.begin() + low, arr.begin() + high + 1, less);
+}
+
+// The sorting engine behind introSort and quickSort: sort [first, last) by less
+template <typename RandomIt, typename Less>
+void introSortRange(RandomIt first, RandomIt last, Less &less)
+{
+  if (last - first < 2) { return; }
+
+  std::size_t depth_limit = 0;
+  for (auto n = last - first; n > 1; n >>= 1)
+  {
+    depth_limit += 2;
+  }
+
+  struct Range
+  {
+    RandomIt first, last;
+    std::size_t depth;
+  };
+  std::vector<Range> stack;
+  stack.push_back({first, last, depth_limit});
+
+  const auto threshold = static_cast<std::ptrdiff_t>(kIntroSortInsertionThreshold);
+  while (!stack.empty())
+  {
+    Range range = stack.back();
+    stack.pop_back();
+
+    while (range.last - range.first > threshold)
+    {
+      if (range.depth == 0)
+      {
+        heapSort(range.first, range.last, less);
+        break;
+      }
+      --range.depth;
+
+      std::iter_swap(range.first, choosePivot(range.first, range.last, less));
+      auto equal = fatPartition(range.first, range.last, less);
+
+      // Defer the larger side and keep working on the smaller one, which bounds the stack to O(log n)
+      Range left{range.first, equal.first, range.depth};
+      Range right{equal.second, range.last, range.depth};
+      bool has_left  = equal.first != range.first;
+      bool has_right = equal.second != range.last;
+      if (!has_left && !has_right) { break; }
+      if (!has_left) { range = right; }
+      else if (!has_right) { range = left; }
+      else if (left.last - left.first < right.last - right.first)
+      {
+        stack.push_back(right);
+        range = left;
+      }
+      else
+      {
+        stack.push_back(left);
+        range = right;
+      }
+    }
+
+    if (range.last - range.first > 1 && range.last - range.first <= threshold)
+    {
+      smallSort(range.first, range.last, less);
+    }
+  }
+}
+
+// Sort [first, last) of any random-access range by comp(proj(a), proj(b)) in place
+template <typename RandomIt, typename Compare = std::less<>, typename Projection = SortIdentity>
+void introSort(RandomIt first, RandomIt last, Compare comp = Compare(), Projection proj = Projection())
+{
+  auto less = projectedCompare(std::move(comp), std::move(proj));
+  introSortRange(first, last, less);
+}
+
+// Function to perform introsort(data, index of left element, index of right element)
+template <typename T>
+void introSort(std::vector<T> &arr, std::size_t low, std::size_t high)
+{
+  if (low >= high || high >= arr.size()) { return; }
+  introSort(arr.begin() + low, arr.begin() + high + 1);
+}
+
+template <typename T>
+void introSort(std::vector<T> &arr)
+{
+  introSort(arr.begin(), arr.end());
+}
+
+#endif // SORTING_INTRO_SORT_H
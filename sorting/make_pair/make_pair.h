@@ -1,6 +1,9 @@
 
 #include <vector>
 #include <algorithm>
+#include <limits>
+
+#include "common/parallel_for.h"
 
 #ifndef SORTING_MAKE_PAIR_H
 #define SORTING_MAKE_PAIR_H
@@ -12,16 +15,23 @@ python3 generate_arrays.py # generate two random arrays
 ```
 */
 
+// Outputs of findPairsParallel are paired on one thread below this many elements of b
+constexpr std::size_t kFindPairsSequentialCutoff = 1 << 16;
+
+// Pair b[begin, end) with a, starting the scan of a at index_a. findPairsOptimized reaches b[begin] with index_a equal
+// to the number of elements of a not greater than b[begin - 1] (0 for begin = 0), so chunks can start anywhere.
 template <typename T>
-std::vector<std::pair<T, T>> findPairsOptimized(const std::vector<T> &a,
-                                                const std::vector<T> &b,
-                                                const T thr)
+void findPairsInRange(const std::vector<T> &a,
+                      const std::vector<T> &b,
+                      std::size_t begin,
+                      std::size_t end,
+                      std::size_t index_a,
+                      const T thr,
+                      std::vector<std::pair<T, T>> &pairs)
 {
-  std::vector<std::pair<T, T>> pairs;
-  size_t index_a = 0; // 用于遍历数组a
-
-  for (T item_b : b)
+  for (std::size_t i = begin; i < end; ++i)
   {
+    T item_b         = b[i];
     T closest_diff   = std::numeric_limits<T>::max();
     T closest_item_a = 0.0;
     bool found       = false;
@@ -58,6 +68,15 @@ std::vector<std::pair<T, T>> findPairsOptimized(const std::vector<T> &a,
 
     // 如果当前a[index_a]大于numB，下一个numB可能还是与当前a[index_a]最接近，所以indexA不需要回退
   }
+}
+
+template <typename T>
+std::vector<std::pair<T, T>> findPairsOptimized(const std::vector<T> &a,
+                                                const std::vector<T> &b,
+                                                const T thr)
+{
+  std::vector<std::pair<T, T>> pairs;
+  findPairsInRange(a, b, 0, b.size(), 0, thr, pairs);
 
   // 对结果进行排序，确保按照升序排列
   std::sort(pairs.begin(), pairs.end());
@@ -65,4 +84,37 @@ std::vector<std::pair<T, T>> findPairsOptimized(const std::vector<T> &a,
   return pairs;
 }
 
+// Same pairs as findPairsOptimized for sorted a and b. Every thread pairs one chunk of b, starting its scan of a at the
+// binary-searched position the sequential scan would have reached; the chunk outputs are already in order, so they are
+// concatenated instead of sorted. num_threads = 0 uses the hardware concurrency.
+template <typename T>
+std::vector<std::pair<T, T>> findPairsParallel(const std::vector<T> &a,
+                                               const std::vector<T> &b,
+                                               const T thr,
+                                               std::size_t num_threads = 0)
+{
+  if (num_threads == 0) { num_threads = bmath::defaultThreadCount(); }
+  num_threads = std::min(num_threads, std::max<std::size_t>(1, b.size() / kFindPairsSequentialCutoff));
+
+  std::vector<std::vector<std::pair<T, T>>> chunks(num_threads);
+  bmath::parallelFor(num_threads, [&](std::size_t t) {
+    std::size_t begin   = b.size() * t / num_threads, end = b.size() * (t + 1) / num_threads;
+    std::size_t index_a = begin == 0 ? 0 : std::upper_bound(a.begin(), a.end(), b[begin - 1]) - a.begin();
+    chunks[t].reserve(end - begin);
+    findPairsInRange(a, b, begin, end, index_a, thr, chunks[t]);
+  });
+  if (num_threads == 1) { return std::move(chunks[0]); }
+
+  std::vector<std::size_t> offsets(num_threads + 1, 0);
+  for (std::size_t t = 0; t < num_threads; ++t)
+  {
+    offsets[t + 1] = offsets[t] + chunks[t].size();
+  }
+  std::vector<std::pair<T, T>> pairs(offsets[num_threads]);
+  bmath::parallelFor(num_threads, [&](std::size_t t) {
+    std::copy(chunks[t].begin(), chunks[t].end(), pairs.begin() + offsets[t]);
+  });
+  return pairs;
+}
+
 #endif // SORTING_MAKE_PAIR_H
\ No newline at end of file
@@ -1,8 +1,36 @@
-
-#include <queue>
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "common/parallel_for.h"
+#include "sorting/sort_view/sort_view.h"
+
 /*Here are several sorted arrays. Merge these arrays and keep new arrat sorted. Here are commands to compile and run.
+
+mergeSortedVectors is a k-way merge driven by a loser tree (tournament tree):
+
+|property|description|
+|---|---|
+|Time Complexity|O(n log k): one leaf-to-root replay of about log2(k) comparisons per output element.|
+|Space Complexity|O(k) besides the output; the result is reserved once, or written through a caller-supplied output iterator.|
+|Element Types|elements are compared in place and copied or moved only once, into the output; move-only types work with the rvalue overload.|
+|Stability|equal keys leave in the order of their input vectors, so the merge is stable.|
+
+parallelMergeSortedVectors splits the output into one equal slice per thread by co-ranking (the k-way merge path):
+every thread finds, on its own, where its first and last output ranks fall in each input and merges that slice with a
+loser tree. Threads share no state, and the output is identical to mergeSortedVectors.
+
+mergeSortedVectorsN merges a compile-time number of vectors of arithmetic keys (sensor streams, mostly 2 to 8): the
+minimum of the N heads is found with a fixed, unrolled chain of conditional moves, and exhausted inputs point at a
+sentinel instead of being tested for every element.
+
+mergeSortedRanges runs the same loser tree over iterator pairs of any type with a comparator and a projection, so
+sorted runs in memory-mapped files or strided views are merged without first being copied into vectors.
 */
 
 #ifndef SORTING_MERGE_VECTOR_H
@@ -15,6 +43,7 @@ std::vector<T> mergeThreeSortedVectors(const std::vector<T> &arr1,
 {
   std::size_t i = 0, j = 0, k = 0;
   std::vector<T> result;
+  result.reserve(arr1.size() + arr2.size() + arr3.size());
 
   while (i < arr1.size() && j < arr2.size() && k < arr3.size())
   {
@@ -63,55 +92,318 @@ std::vector<T> mergeThreeSortedVectors(const std::vector<T> &arr1,
   return result;
 }
 
-// 定义一个用于存储元素和其来源数组索引的结构体
-template <typename T>
-struct Element
+// Branchless merge of N sorted vectors of arithmetic keys into storage sized once.
+// The merge runs in phases: no input can run out within as many steps as the shortest input has left, so the inner
+// loop checks nothing. Between phases an exhausted input is parked on a sentinel that never advances; a real key
+// equal to the sentinel may be emitted as the sentinel, which is the same value.
+template <std::size_t N, typename T>
+std::vector<T> mergeSortedVectorsN(const std::array<const std::vector<T> *, N> &arrays)
 {
-  T value;
-  int array_index;
-  int element_index;
-};
+  static_assert(N > 0, "mergeSortedVectorsN needs at least one input");
+  static_assert(std::is_arithmetic<T>::value, "mergeSortedVectorsN needs arithmetic keys for its sentinel");
+  static constexpr T kSentinel = std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                                      : std::numeric_limits<T>::max();
 
-// 比较函数，用于构建最小堆
-template <typename T>
-struct Compare
+  std::array<const T *, N> heads, ends;
+  std::array<std::size_t, N> steps;
+  std::size_t total = 0;
+  for (std::size_t i = 0; i < N; ++i)
+  {
+    heads[i] = arrays[i]->data();
+    ends[i]  = heads[i] + arrays[i]->size();
+    steps[i] = 1;
+    total += arrays[i]->size();
+  }
+
+  std::vector<T> result(total);
+  T *out = result.data();
+  for (std::size_t written = 0; written < total;)
+  {
+    std::size_t phase = total - written;
+    for (std::size_t i = 0; i < N; ++i)
+    {
+      if (steps[i] != 0 && heads[i] == ends[i])
+      {
+        heads[i] = &kSentinel;
+        steps[i] = 0;
+      }
+      if (steps[i] != 0) { phase = std::min(phase, static_cast<std::size_t>(ends[i] - heads[i])); }
+    }
+
+    for (std::size_t k = 0; k < phase; ++k)
+    {
+      std::size_t best = 0;
+      T value          = *heads[0];
+      for (std::size_t i = 1; i < N; ++i)
+      {
+        T candidate = *heads[i];
+        bool less   = candidate < value;
+        best        = less ? i : best;
+        value       = less ? candidate : value;
+      }
+      out[k] = value;
+      for (std::size_t i = 0; i < N; ++i)
+      {
+        heads[i] += i == best ? steps[i] : 0; // unrolled, so the heads stay in registers
+      }
+    }
+    out += phase;
+    written += phase;
+  }
+  return result;
+}
+
+// mergeSortedVectorsN(a, b, c) merges three vectors with the arity fixed at compile time
+template <typename T, typename... Vectors>
+std::vector<T> mergeSortedVectorsN(const std::vector<T> &first, const Vectors &...rest)
 {
-  bool operator()(Element<T> const &e1, Element<T> const &e2)
+  return mergeSortedVectorsN<1 + sizeof...(Vectors), T>({&first, &rest...});
+}
+
+// Tournament tree over k sorted ranges [first, last). Internal node i (1 <= i < k) stores the source that lost the
+// match played there, node 0 the overall winner, and the leaf of source s is node s + k. After the winner's head is
+// consumed only the matches on its leaf-to-root path are replayed. Ranges must be sorted by less.
+template <typename Iterator, typename Less = std::less<>>
+class LoserTree
+{
+ public:
+  explicit LoserTree(std::vector<std::pair<Iterator, Iterator>> ranges, Less less = Less()) :
+    ranges_(std::move(ranges)), tree_(ranges_.size(), 0), less_(std::move(less))
+  {
+    const std::size_t k = ranges_.size();
+    if (k < 2) { return; }
+
+    std::vector<std::size_t> winners(2 * k);
+    for (std::size_t s = 0; s < k; ++s)
+    {
+      winners[s + k] = s;
+    }
+    for (std::size_t node = k - 1; node > 0; --node)
+    {
+      std::size_t a = winners[2 * node], b = winners[2 * node + 1];
+      if (beats(b, a)) { std::swap(a, b); }
+      winners[node] = a;
+      tree_[node]   = b;
+    }
+    tree_[0] = winners[1];
+  }
+
+  bool empty() const { return ranges_.empty() || exhausted(tree_[0]); }
+
+  // Source index and position of the smallest remaining element
+  std::size_t winner() const { return tree_[0]; }
+  Iterator front() const { return ranges_[tree_[0]].first; }
+
+  // Consume the smallest remaining element
+  void pop()
+  {
+    std::size_t winner = tree_[0];
+    ++ranges_[winner].first;
+    for (std::size_t node = (winner + ranges_.size()) / 2; node > 0; node /= 2)
+    {
+      if (beats(tree_[node], winner)) { std::swap(tree_[node], winner); }
+    }
+    tree_[0] = winner;
+  }
+
+  // Write every remaining element to out in order and return the end of the output
+  template <typename OutputIt>
+  OutputIt drain(OutputIt out)
+  {
+    while (!empty())
+    {
+      *out = *front();
+      ++out;
+      pop();
+    }
+    return out;
+  }
+
+ private:
+  bool exhausted(std::size_t s) const { return ranges_[s].first == ranges_[s].second; }
+
+  // Whether the head of source a leaves before the head of source b; ties go to the lower source index
+  bool beats(std::size_t a, std::size_t b) const
   {
-    return e1.value > e2.value;
+    if (exhausted(a)) { return false; }
+    if (exhausted(b)) { return true; }
+    const auto &x = *ranges_[a].first; // bound by reference: a move_iterator head is not moved from here
+    const auto &y = *ranges_[b].first;
+    return a < b ? !less_(y, x) : less_(x, y);
   }
+
+  std::vector<std::pair<Iterator, Iterator>> ranges_;
+  std::vector<std::size_t> tree_;
+  Less less_;
 };
 
+// Merge ranges of any iterator type (Spans over mapped files, StridedSpans, ...), each sorted by
+// comp(proj(a), proj(b)), into out and return the end of the output. The merge is stable, as for mergeSortedVectors.
+template <typename Iterator, typename OutputIt, typename Compare = std::less<>, typename Projection = SortIdentity>
+OutputIt mergeSortedRanges(std::vector<std::pair<Iterator, Iterator>> ranges, OutputIt out, Compare comp = Compare(),
+                           Projection proj = Projection())
+{
+  auto less = projectedCompare(std::move(comp), std::move(proj));
+  return LoserTree<Iterator, decltype(less)>(std::move(ranges), std::move(less)).drain(out);
+}
+
+// Merge sorted vectors into out (e.g. a pointer into a pre-sized buffer) and return the end of the output
+template <typename T, typename OutputIt>
+OutputIt mergeSortedVectors(const std::vector<std::vector<T>> &arrays, OutputIt out)
+{
+  using Iterator = typename std::vector<T>::const_iterator;
+  std::vector<std::pair<Iterator, Iterator>> ranges;
+  ranges.reserve(arrays.size());
+  for (const auto &array : arrays)
+  {
+    if (!array.empty()) { ranges.emplace_back(array.begin(), array.end()); }
+  }
+  return LoserTree<Iterator>(std::move(ranges)).drain(out);
+}
+
 template <typename T>
 std::vector<T> mergeSortedVectors(const std::vector<std::vector<T>> &arrays)
 {
-  std::priority_queue<Element<T>, std::vector<Element<T>>, Compare<T>> min_heap;
-  std::vector<int> result;
+  std::size_t total = 0;
+  for (const auto &array : arrays)
+  {
+    total += array.size();
+  }
+  std::vector<T> result;
+  result.reserve(total);
+  mergeSortedVectors(arrays, std::back_inserter(result));
+  return result;
+}
+
+// Merge by moving the elements out of the inputs, which are left holding moved-from values
+template <typename T>
+std::vector<T> mergeSortedVectors(std::vector<std::vector<T>> &&arrays)
+{
+  using Iterator = std::move_iterator<typename std::vector<T>::iterator>;
+  std::vector<std::pair<Iterator, Iterator>> ranges;
+  ranges.reserve(arrays.size());
+  std::size_t total = 0;
+  for (auto &array : arrays)
+  {
+    total += array.size();
+    if (!array.empty()) { ranges.emplace_back(std::make_move_iterator(array.begin()), std::make_move_iterator(array.end())); }
+  }
+  std::vector<T> result;
+  result.reserve(total);
+  LoserTree<Iterator>(std::move(ranges)).drain(std::back_inserter(result));
+  return result;
+}
+
+// Outputs shorter than this many elements per thread are merged on fewer threads
+constexpr std::size_t kParallelMergeSequentialCutoff = 1 << 16;
+
+// Co-rank: positions p[j] in each sorted range, summing to rank, such that the elements before them are the first
+// rank outputs of the stable merge. Needs random-access iterators. A round halves the widest of the k windows, so it
+// takes at most O(k log n) rounds of k binary searches: O(k^2 log^2 n) comparisons in the worst case.
+template <typename Iterator>
+std::vector<std::size_t> mergePathSplit(const std::vector<std::pair<Iterator, Iterator>> &ranges, std::size_t rank)
+{
+  const std::size_t k = ranges.size();
+  // p[j] lies in the window [lo[j], hi[j]]
+  std::vector<std::size_t> lo(k, 0), hi(k), count(k);
+  std::size_t lo_sum = 0, hi_sum = 0;
+  for (std::size_t j = 0; j < k; ++j)
+  {
+    hi[j] = static_cast<std::size_t>(ranges[j].second - ranges[j].first);
+    hi_sum += hi[j];
+  }
+  if (rank >= hi_sum) { return hi; }
 
-  // 初始化堆，将每个数组的第一个元素加入到堆中
-  for (int i = 0; i < arrays.size(); ++i)
+  while (lo_sum < rank && hi_sum > rank)
   {
-    if (!arrays[i].empty())
+    // Probe the middle of the widest window: it always shrinks, and the other windows shrink around the probe
+    std::size_t s = 0;
+    for (std::size_t j = 1; j < k; ++j)
+    {
+      if (hi[j] - lo[j] > hi[s] - lo[s]) { s = j; }
+    }
+    std::size_t m     = lo[s] + (hi[s] - lo[s]) / 2;
+    const auto &pivot = ranges[s].first[m];
+
+    // count[j]: elements of range j that leave before the pivot, clamped to the window. Ties leave lower ranges first.
+    std::size_t below = 0;
+    for (std::size_t j = 0; j < k; ++j)
+    {
+      Iterator first = ranges[j].first + lo[j], last = ranges[j].first + hi[j];
+      if (j < s) { count[j] = static_cast<std::size_t>(std::upper_bound(first, last, pivot) - ranges[j].first); }
+      else if (j > s) { count[j] = static_cast<std::size_t>(std::lower_bound(first, last, pivot) - ranges[j].first); }
+      else { count[j] = m; }
+      below += count[j];
+    }
+
+    if (below < rank)
+    {
+      // The pivot is among the first rank outputs, and so is everything before it
+      count[s] = m + 1;
+      lo_sum   = 0;
+      for (std::size_t j = 0; j < k; ++j)
+      {
+        lo[j] = count[j];
+        lo_sum += lo[j];
+      }
+    }
+    else
     {
-      min_heap.push({arrays[i][0], i, 0});
+      hi_sum = 0;
+      for (std::size_t j = 0; j < k; ++j)
+      {
+        hi[j] = count[j];
+        hi_sum += hi[j];
+      }
     }
   }
+  return lo_sum == rank ? lo : hi;
+}
 
-  // 循环直到堆为空
-  while (!min_heap.empty())
+// Merge sorted vectors into the random-access output out on num_threads threads (0 uses the hardware concurrency)
+template <typename T, typename RandomIt>
+RandomIt parallelMergeSortedVectors(const std::vector<std::vector<T>> &arrays, RandomIt out, std::size_t num_threads = 0)
+{
+  using Iterator = typename std::vector<T>::const_iterator;
+  std::vector<std::pair<Iterator, Iterator>> ranges;
+  ranges.reserve(arrays.size());
+  std::size_t total = 0;
+  for (const auto &array : arrays)
   {
-    Element current = min_heap.top();
-    min_heap.pop();
-    result.push_back(current.value);
+    if (!array.empty()) { ranges.emplace_back(array.begin(), array.end()); }
+    total += array.size();
+  }
+
+  if (num_threads == 0) { num_threads = bmath::defaultThreadCount(); }
+  num_threads = std::min(num_threads, std::max<std::size_t>(1, total / kParallelMergeSequentialCutoff));
+  if (num_threads < 2) { return LoserTree<Iterator>(std::move(ranges)).drain(out); }
+
+  bmath::parallelFor(num_threads, [&](std::size_t t) {
+    std::size_t begin = total * t / num_threads, end = total * (t + 1) / num_threads;
+    std::vector<std::size_t> first = mergePathSplit(ranges, begin), last = mergePathSplit(ranges, end);
 
-    // 如果当前数组中还有元素，将下一个元素加入堆中
-    if (current.element_index + 1 < arrays[current.array_index].size())
+    std::vector<std::pair<Iterator, Iterator>> slice(ranges.size());
+    for (std::size_t j = 0; j < ranges.size(); ++j)
     {
-      min_heap.push({arrays[current.array_index][current.element_index + 1], current.array_index, current.element_index + 1});
+      slice[j] = {ranges[j].first + first[j], ranges[j].first + last[j]};
     }
-  }
+    LoserTree<Iterator>(std::move(slice)).drain(out + begin);
+  });
+  return out + total;
+}
 
+// T must be default-constructible: the result is sized up front so that every thread writes its own slice
+template <typename T>
+std::vector<T> parallelMergeSortedVectors(const std::vector<std::vector<T>> &arrays, std::size_t num_threads = 0)
+{
+  std::size_t total = 0;
+  for (const auto &array : arrays)
+  {
+    total += array.size();
+  }
+  std::vector<T> result(total);
+  parallelMergeSortedVectors(arrays, result.begin(), num_threads);
   return result;
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,2 @@
+
+#include "sorting/parallel_sort/parallel_sort.h"
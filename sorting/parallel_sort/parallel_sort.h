@@ -0,0 +1,130 @@
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "common/parallel_for.h"
+#include "sorting/intro_sort/intro_sort.h"
+
+#ifndef SORTING_PARALLEL_SORT_H
+#define SORTING_PARALLEL_SORT_H
+
+/*
+Parallel sample sort.
+1. Draw `threads * kParallelSortOversampling` random samples and pick `threads - 1` evenly spaced splitters from them;
+   a key sampled often enough to be chosen twice becomes one splitter.
+2. Every thread counts how many elements of its contiguous chunk fall into each bucket. Every splitter has an equality
+   bucket for the keys equal to it, between the buckets of the keys strictly below and above it (IPS4o).
+3. A prefix sum over (bucket, thread) gives every thread a private output slice per bucket, so the scatter into the
+   buffer needs no synchronization.
+4. Every thread sorts one non-equality bucket with `introSort`; equality buckets are sorted already. The buffer is
+   moved back into the input in equal slices.
+
+|property|description|
+|---|---|
+|Time Complexity|O(n log n / p) expected with p threads|
+|Space Complexity|O(n): one buffer of n elements plus O(p²) counters.|
+|Scaling|every pass is split evenly over the threads; a bucket to sort holds about n / p elements. A key that fills more than 1 / p of the input is almost surely a splitter, so its copies go to an equality bucket and cost no sorting.|
+|Not Stable|it does not preserve the relative order of equal elements.|
+*/
+
+// Arrays shorter than this are sorted by introSort on the calling thread
+constexpr std::size_t kParallelSortSequentialCutoff = 1 << 16;
+// Samples drawn per bucket; larger values balance buckets better
+constexpr std::size_t kParallelSortOversampling = 64;
+
+// num_threads = 0 uses the hardware concurrency
+template <typename T>
+void parallelSort(std::vector<T> &arr, std::size_t num_threads = 0,
+                  std::size_t sequential_cutoff = kParallelSortSequentialCutoff)
+{
+  const std::size_t n = arr.size();
+  if (num_threads == 0) { num_threads = bmath::defaultThreadCount(); }
+  if (sequential_cutoff < 2) { sequential_cutoff = 2; }
+  num_threads = std::min(num_threads, std::max<std::size_t>(1, n / sequential_cutoff));
+  if (num_threads < 2 || n < sequential_cutoff)
+  {
+    introSort(arr);
+    return;
+  }
+
+  const std::size_t p = num_threads;
+
+  // Choose splitters from a fixed-seed random sample so the result does not depend on input order patterns
+  std::vector<T> samples;
+  samples.reserve(p * kParallelSortOversampling);
+  std::minstd_rand gen(2024);
+  std::uniform_int_distribution<std::size_t> dist(0, n - 1);
+  for (std::size_t i = 0; i < p * kParallelSortOversampling; ++i)
+  {
+    samples.push_back(arr[dist(gen)]);
+  }
+  introSort(samples);
+  std::vector<T> splitters;
+  splitters.reserve(p - 1);
+  for (std::size_t b = 1; b < p; ++b)
+  {
+    splitters.push_back(samples[b * kParallelSortOversampling]);
+  }
+  // A key drawn several times is one splitter with its own equality bucket
+  splitters.erase(std::unique(splitters.begin(), splitters.end(), [](const T &a, const T &b) { return !(a < b); }),
+                  splitters.end());
+
+  // Bucket 2i holds the keys strictly between splitters i - 1 and i, bucket 2i + 1 the keys equal to splitter i
+  const std::size_t buckets = 2 * splitters.size() + 1;
+  auto chunkBegin           = [n, p](std::size_t t) { return t * (n / p) + std::min(t, n % p); };
+  auto bucketOf             = [&splitters](const T &value) {
+    std::size_t i = static_cast<std::size_t>(std::upper_bound(splitters.begin(), splitters.end(), value) - splitters.begin());
+    return i > 0 && !(splitters[i - 1] < value) ? 2 * i - 1 : 2 * i;
+  };
+
+  // counts[t * buckets + b]: elements of chunk t that belong to bucket b
+  std::vector<std::size_t> counts(p * buckets, 0);
+  bmath::parallelFor(p, [&](std::size_t t) {
+    std::size_t *count = &counts[t * buckets];
+    for (std::size_t i = chunkBegin(t); i < chunkBegin(t + 1); ++i)
+    {
+      ++count[bucketOf(arr[i])];
+    }
+  });
+
+  // Bucket-major prefix sum turns the counts into write offsets
+  std::vector<std::size_t> bucket_begin(buckets + 1, 0);
+  std::size_t offset = 0;
+  for (std::size_t b = 0; b < buckets; ++b)
+  {
+    bucket_begin[b] = offset;
+    for (std::size_t t = 0; t < p; ++t)
+    {
+      std::size_t count       = counts[t * buckets + b];
+      counts[t * buckets + b] = offset;
+      offset += count;
+    }
+  }
+  bucket_begin[buckets] = n;
+
+  std::vector<T> buffer(n);
+  bmath::parallelFor(p, [&](std::size_t t) {
+    std::size_t *write = &counts[t * buckets];
+    for (std::size_t i = chunkBegin(t); i < chunkBegin(t + 1); ++i)
+    {
+      buffer[write[bucketOf(arr[i])]++] = std::move(arr[i]);
+    }
+  });
+
+  // Equality buckets are already sorted; there are at most p buckets left to sort
+  bmath::parallelFor(p, [&](std::size_t t) {
+    for (std::size_t b = 2 * t; b < buckets; b += 2 * p)
+    {
+      std::size_t low = bucket_begin[b], end = bucket_begin[b + 1];
+      if (end - low > 1) { introSort(buffer, low, end - 1); }
+    }
+  });
+  // The copy back is split by position, so a heavy equality bucket does not fall on one thread
+  bmath::parallelFor(p, [&](std::size_t t) {
+    std::move(buffer.begin() + chunkBegin(t), buffer.begin() + chunkBegin(t + 1), arr.begin() + chunkBegin(t));
+  });
+}
+
+#endif // SORTING_PARALLEL_SORT_H
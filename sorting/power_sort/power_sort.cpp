@@ -0,0 +1,2 @@
+
+#include "sorting/power_sort/power_sort.h"
@@ -0,0 +1,246 @@
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "sorting/insert_sort/insert_sort.h"
+
+#ifndef SORTING_POWER_SORT_H
+#define SORTING_POWER_SORT_H
+
+/*
+Powersort (Munro and Wild 2018): a natural merge sort that finds the runs already present in the input and merges
+them in a nearly optimal order. It is the merge policy of CPython's list.sort.
+1. Find the next run: the longest non-decreasing prefix, or the longest strictly decreasing one, which is reversed.
+   A run shorter than kPowerSortMinRun is extended with `insertSort`.
+2. The power of the boundary between two runs is the depth at which a binary split of [0, n) would separate their
+   midpoints. Runs on a stack are merged while the boundary below the top is deeper than the new boundary.
+3. A merge skips the prefix of the left run and the suffix of the right run that are already in place, copies the
+   shorter side to the scratch buffer and merges. After kPowerSortGallop wins in a row from one side it gallops:
+   an exponential search finds the whole block that comes next from that side, and the block is moved at once.
+
+|property|description|
+|---|---|
+|Time Complexity|O(n + n H), where H <= log2(number of runs) is the entropy of the run lengths: O(n) on presorted or reversed input, O(n log n) in the worst case.|
+|Space Complexity|O(n / 2) scratch, reusable across calls; O(log n) run stack.|
+|Stability|it preserves the relative order of equal elements.|
+|Adaptive|galloping moves long blocks from one run in O(log block) comparisons.|
+*/
+
+// Runs shorter than this are extended with insertion sort
+constexpr std::size_t kPowerSortMinRun = 24;
+// Consecutive wins from one run after which a merge starts galloping
+constexpr std::size_t kPowerSortGallop = 7;
+
+// First position in [first, last) where pred stops holding (pred must hold on a prefix), found by exponential search
+// from the front, so a short prefix costs few comparisons
+template <typename Iterator, typename Predicate>
+Iterator gallopFront(Iterator first, Iterator last, Predicate pred)
+{
+  const std::size_t n = static_cast<std::size_t>(last - first);
+  std::size_t known = 0, step = 1;
+  while (step < n && pred(first[step]))
+  {
+    known = step;
+    step  = 2 * step + 1;
+  }
+  return std::partition_point(first + known, first + std::min(step, n), pred);
+}
+
+// First position of the suffix of [first, last) where pred holds (pred must hold on a suffix), found by exponential
+// search from the back
+template <typename Iterator, typename Predicate>
+Iterator gallopBack(Iterator first, Iterator last, Predicate pred)
+{
+  const std::size_t n = static_cast<std::size_t>(last - first);
+  std::size_t known = 0, step = 1;
+  while (step < n && pred(last[-1 - static_cast<std::ptrdiff_t>(step)]))
+  {
+    known = step;
+    step  = 2 * step + 1;
+  }
+  return std::partition_point(last - std::min(step, n), last - known, [&pred](const auto &x) { return !pred(x); });
+}
+
+// Power of the boundary between the runs [s1, s1 + n1) and [s1 + n1, s1 + n1 + n2) of an array of n elements
+inline unsigned powerSortPower(std::size_t s1, std::size_t n1, std::size_t n2, std::size_t n)
+{
+  unsigned power = 0;
+  std::size_t a  = 2 * s1 + n1; // twice the midpoint of the first run
+  std::size_t b  = a + n1 + n2; // twice the midpoint of the second run
+  while (true)
+  {
+    ++power;
+    if (a >= n)
+    {
+      a -= n;
+      b -= n;
+    }
+    else if (b >= n) { break; }
+    a <<= 1;
+    b <<= 1;
+  }
+  return power;
+}
+
+// Stable merge of the sorted ranges [lo, mid) and [mid, hi)
+template <typename T>
+void powerSortMerge(std::vector<T> &arr, std::size_t lo, std::size_t mid, std::size_t hi, std::vector<T> &scratch)
+{
+  auto base = arr.begin();
+  // Left elements not greater than the first right element, and right elements not less than the last left element,
+  // are already in place
+  lo = static_cast<std::size_t>(gallopFront(base + lo, base + mid, [&](const T &x) { return !(arr[mid] < x); }) - base);
+  if (lo == mid) { return; }
+  hi = static_cast<std::size_t>(gallopBack(base + mid, base + hi, [&](const T &x) { return !(x < arr[mid - 1]); }) - base);
+  if (hi == mid) { return; }
+
+  std::size_t wins_left = 0, wins_right = 0;
+  if (mid - lo <= hi - mid)
+  {
+    // Merge forwards with the left run in the scratch buffer
+    scratch.assign(std::make_move_iterator(base + lo), std::make_move_iterator(base + mid));
+    auto left = scratch.begin(), left_end = scratch.end();
+    auto right = base + mid, right_end = base + hi, out = base + lo;
+    while (left != left_end && right != right_end)
+    {
+      if (*right < *left)
+      {
+        *out++ = std::move(*right++);
+        wins_left = 0;
+        if (++wins_right >= kPowerSortGallop && right != right_end)
+        {
+          auto block = gallopFront(right, right_end, [&](const T &x) { return x < *left; });
+          out        = std::move(right, block, out);
+          right      = block;
+          wins_right = 0;
+        }
+      }
+      else
+      {
+        *out++ = std::move(*left++);
+        wins_right = 0;
+        if (++wins_left >= kPowerSortGallop && left != left_end)
+        {
+          auto block = gallopFront(left, left_end, [&](const T &x) { return !(*right < x); });
+          out        = std::move(left, block, out);
+          left       = block;
+          wins_left  = 0;
+        }
+      }
+    }
+    std::move(left, left_end, out); // the rest of the right run is already in place
+  }
+  else
+  {
+    // Merge backwards with the right run in the scratch buffer
+    scratch.assign(std::make_move_iterator(base + mid), std::make_move_iterator(base + hi));
+    auto left_begin = base + lo, left = base + mid, right_begin = scratch.begin(), right = scratch.end();
+    auto out = base + hi;
+    while (left != left_begin && right != right_begin)
+    {
+      if (*(right - 1) < *(left - 1))
+      {
+        *--out     = std::move(*--left);
+        wins_right = 0;
+        if (++wins_left >= kPowerSortGallop && left != left_begin)
+        {
+          const T &key = *(right - 1);
+          auto block   = gallopBack(left_begin, left, [&](const T &x) { return key < x; });
+          out          = std::move_backward(block, left, out);
+          left         = block;
+          wins_left    = 0;
+        }
+      }
+      else
+      {
+        *--out    = std::move(*--right);
+        wins_left = 0;
+        if (++wins_right >= kPowerSortGallop && right != right_begin)
+        {
+          const T &key = *(left - 1);
+          auto block   = gallopBack(right_begin, right, [&](const T &x) { return !(x < key); });
+          out          = std::move_backward(block, right, out);
+          right        = block;
+          wins_right   = 0;
+        }
+      }
+    }
+    std::move_backward(right_begin, right, out); // the rest of the left run is already in place
+  }
+}
+
+// Stable sort; scratch is reused between calls so repeated sorts do not allocate
+template <typename T>
+void powerSort(std::vector<T> &arr, std::vector<T> &scratch)
+{
+  struct Run
+  {
+    std::size_t start, length;
+    unsigned power; // of the boundary with the run below it on the stack
+  };
+
+  const std::size_t n = arr.size();
+  if (n < 2) { return; }
+
+  std::vector<Run> stack;
+  auto mergeTop = [&]() {
+    Run right = stack.back();
+    stack.pop_back();
+    Run &left = stack.back();
+    powerSortMerge(arr, left.start, right.start, right.start + right.length, scratch);
+    left.length += right.length;
+  };
+
+  for (std::size_t start = 0; start < n;)
+  {
+    // Find the next natural run; strictly decreasing runs are reversed, which keeps equal elements in order
+    std::size_t end = start + 1;
+    if (end < n && arr[end] < arr[start])
+    {
+      while (end < n && arr[end] < arr[end - 1])
+      {
+        ++end;
+      }
+      std::reverse(arr.begin() + start, arr.begin() + end);
+    }
+    else
+    {
+      while (end < n && !(arr[end] < arr[end - 1]))
+      {
+        ++end;
+      }
+    }
+    if (end - start < kPowerSortMinRun && end < n)
+    {
+      end = std::min(n, start + kPowerSortMinRun);
+      insertSort(arr, start, end - 1);
+    }
+
+    Run run = {start, end - start, 0};
+    if (!stack.empty())
+    {
+      run.power = powerSortPower(stack.back().start, stack.back().length, run.length, n);
+      while (stack.size() > 1 && stack.back().power > run.power)
+      {
+        mergeTop();
+      }
+    }
+    stack.push_back(run);
+    start = end;
+  }
+  while (stack.size() > 1)
+  {
+    mergeTop();
+  }
+}
+
+template <typename T>
+void powerSort(std::vector<T> &arr)
+{
+  std::vector<T> scratch;
+  powerSort(arr, scratch);
+}
+
+#endif // SORTING_POWER_SORT_H
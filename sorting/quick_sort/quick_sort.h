@@ -1,71 +1,52 @@
 
+#include <functional>
 #include <vector>
 
+#include "sorting/intro_sort/intro_sort.h"
+#include "sorting/sort_view/sort_view.h"
+
 #ifndef SORTING_QUICK_SORT_H
 #define SORTING_QUICK_SORT_H
 
 /*
 |property|description|
 |---|---|
-|Time Complexity|best case: O(n log n), average case: O(n log n), worst case: O(n²)|
-|Space Complexity|O(log n): it is an in-place sorting algorithm, meaning it requires only a small amount of additional stack space for the recursive calls.
-|
+|Time Complexity|best case: O(n) (all keys equal), average case: O(n log n), worst case: O(n log n)|
+|Space Complexity|O(log n): the smaller partition is always sorted first, so the explicit stack stays logarithmic.|
 |Fast Average Performance|can handle large datasets efficiently|
-|Adaptable|using insertion sort for small sub-arrays.|
-|Worst-Case Performance|O(n²)|
+|Adaptable|using a sorting network or insertion sort for small sub-arrays.|
+|Iterators|the iterator overload sorts any random-access range with a comparator and a projection.|
+|Implementation|both overloads run `introSortRange` (intro_sort.h): ninther pivots, three-way partitioning and a heapsort fallback, so sorted input and runs of equal keys stay O(n log n).|
 |Not Stable|it does not preserve the relative order of equal elements.|
-|Recursion Overhead|it can lead to stack overflow issues for very large arrays or poor pivot choices.|
 */
 
-// Function to partition the array on the basis of pivot
-template <typename T>
-std::size_t partition(std::vector<T> &arr, std::size_t low, std::size_t high)
+// Sort [first, last) of any random-access range (a Span, a StridedSpan, Eigen's STL iterators, ...) by
+// comp(proj(a), proj(b)) in place
+template <typename RandomIt, typename Compare = std::less<>, typename Projection = SortIdentity>
+void quickSort(RandomIt first, RandomIt last, Compare comp = Compare(), Projection proj = Projection())
 {
-  std::size_t pivot = arr[high]; // Choosing the rightmost element as pivot
-  std::size_t i     = (low - 1); // Index of smaller element
-
-  for (std::size_t j = low; j <= high - 1; j++)
-  {
-    // If current element is smaller than the pivot
-    if (arr[j] < pivot)
-    {
-      i++; // Increment index of smaller element
-      std::swap(arr[i], arr[j]);
-    }
-  }
-  std::swap(arr[i + 1], arr[high]); // move the pivot to middle of larger and smaller
-  return (i + 1);
+  auto less = projectedCompare(std::move(comp), std::move(proj));
+  introSortRange(first, last, less);
 }
 
 // Function to perform quick sort(data, index of left elememt, index of right)
 template <typename T>
 void quickSort(std::vector<T> &arr, std::size_t low, std::size_t high)
 {
-  if (low < high)
-  {
-    // Partition the array and get the partitioning index
-    std::size_t pi = partition(arr, low, high);
-
-    // Recursively sort elements before and after partition
-    quickSort(arr, low, pi - 1);
-    quickSort(arr, pi + 1, high);
-  }
+  if (low >= high || high >= arr.size()) { return; }
+  quickSort(arr.begin() + low, arr.begin() + high + 1);
 }
 
 #endif // SORTING_QUICK_SORT_H
 
 /*
 Explanation :
-1. Partition Function :
-  This function takes the last element as pivot and places it at the correct position in the sorted array.All elements
-  smaller than the pivot are moved to the left, and all greater elements are moved to the right.
-
-2.QuickSort Function :
-  This is a recursive function that sorts the array.It calls the partition function to get the pivot index and then
-  recursively sorts the sub-arrays.
-
-3.Main Function :
-  An example array is initialized and printed.The quickSort function is called to sort the array.The sorted array is
-  printed.This implementation ensures the quick sort algorithm is performed correctly with a complexity of (n log n)
-  on average.
-*/
\ No newline at end of file
+1. Partition :
+  The pivot is the median of three elements (of three medians of three for long ranges). A three-way partition moves
+  the smaller elements to the left, the greater ones to the right and the ones equal to the pivot to the middle, where
+  they are already in their final place.
+
+2. Sorting loop :
+  The smaller side is sorted first and the larger one is deferred, which keeps the stack logarithmic. Short ranges are
+  finished by smallSort, and a range that is partitioned too often is finished by heapsort, so no input is quadratic.
+*/
@@ -0,0 +1,2 @@
+
+#include "sorting/radix_sort/radix_sort.h"
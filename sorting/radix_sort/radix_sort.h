@@ -0,0 +1,163 @@
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "common/parallel_for.h"
+
+#ifndef SORTING_RADIX_SORT_H
+#define SORTING_RADIX_SORT_H
+
+/*
+LSD radix sort on 8-bit digits for integer and floating-point keys.
+
+|property|description|
+|---|---|
+|Time Complexity|O(n * sizeof(key)): one histogram pass over the input, then one scatter pass per byte of the key.|
+|Space Complexity|O(n): one buffer of n elements.|
+|Skipped Passes|a digit that is the same for every key (e.g. the high bytes of small IDs) costs no scatter pass.|
+|Key Extraction|a functor maps each element to its key, so structs are sorted by a field without a comparator.|
+|Stability|it preserves the relative order of equal keys.|
+|Floating Point|keys are ordered by their bits after flipping: -0.0 sorts before +0.0, and NaNs go to the ends by sign.|
+*/
+
+// Inputs shorter than this build the histogram on one thread even when more are requested
+constexpr std::size_t kRadixSortParallelCutoff = 1 << 16;
+
+template <std::size_t kBytes>
+struct RadixUnsigned;
+template <>
+struct RadixUnsigned<1>
+{
+  using type = std::uint8_t;
+};
+template <>
+struct RadixUnsigned<2>
+{
+  using type = std::uint16_t;
+};
+template <>
+struct RadixUnsigned<4>
+{
+  using type = std::uint32_t;
+};
+template <>
+struct RadixUnsigned<8>
+{
+  using type = std::uint64_t;
+};
+
+// Map a key to an unsigned integer with the same order
+template <typename Key>
+typename RadixUnsigned<sizeof(Key)>::type radixKeyBits(Key key)
+{
+  static_assert(std::is_arithmetic<Key>::value, "radix sort keys must be integers or floating-point numbers");
+  using U              = typename RadixUnsigned<sizeof(Key)>::type;
+  constexpr U kSignBit = U(1) << (8 * sizeof(Key) - 1);
+
+  U bits;
+  std::memcpy(&bits, &key, sizeof(Key));
+  if constexpr (std::is_floating_point<Key>::value)
+  {
+    // Negative numbers: flip every bit to reverse their order; positive numbers: set the sign bit
+    return (bits & kSignBit) ? U(~bits) : U(bits | kSignBit);
+  }
+  else if constexpr (std::is_signed<Key>::value)
+  {
+    return U(bits ^ kSignBit);
+  }
+  else
+  {
+    return bits;
+  }
+}
+
+// key(element) returns the integer or floating-point key; num_threads > 1 builds the histograms in parallel
+template <typename T, typename KeyExtractor,
+          typename = typename std::enable_if<std::is_invocable<KeyExtractor, const T &>::value>::type>
+void radixSort(std::vector<T> &arr, KeyExtractor key, std::size_t num_threads = 1)
+{
+  using Key                      = typename std::decay<decltype(key(arr[0]))>::type;
+  constexpr std::size_t kPasses  = sizeof(Key);
+  constexpr std::size_t kBuckets = 256;
+
+  const std::size_t n = arr.size();
+  if (n < 2) { return; }
+
+  auto digitOf = [&key](const T &element, std::size_t pass) {
+    return static_cast<std::size_t>((radixKeyBits(key(element)) >> (8 * pass)) & 0xFF);
+  };
+
+  // Histograms of every digit position in a single read of the input
+  std::vector<std::size_t> counts(kPasses * kBuckets, 0);
+  if (num_threads == 0) { num_threads = bmath::defaultThreadCount(); }
+  if (num_threads > 1 && n >= kRadixSortParallelCutoff)
+  {
+    std::vector<std::vector<std::size_t>> partial(num_threads, std::vector<std::size_t>(kPasses * kBuckets, 0));
+    bmath::parallelFor(num_threads, [&](std::size_t t) {
+      std::size_t begin = n * t / num_threads, end = n * (t + 1) / num_threads;
+      for (std::size_t i = begin; i < end; ++i)
+      {
+        auto bits = radixKeyBits(key(arr[i]));
+        for (std::size_t pass = 0; pass < kPasses; ++pass)
+        {
+          ++partial[t][pass * kBuckets + ((bits >> (8 * pass)) & 0xFF)];
+        }
+      }
+    });
+    for (const auto &thread_counts : partial)
+    {
+      for (std::size_t i = 0; i < counts.size(); ++i)
+      {
+        counts[i] += thread_counts[i];
+      }
+    }
+  }
+  else
+  {
+    for (const T &element : arr)
+    {
+      auto bits = radixKeyBits(key(element));
+      for (std::size_t pass = 0; pass < kPasses; ++pass)
+      {
+        ++counts[pass * kBuckets + ((bits >> (8 * pass)) & 0xFF)];
+      }
+    }
+  }
+
+  std::vector<T> buffer(n);
+  T *src = arr.data(), *dst = buffer.data();
+  for (std::size_t pass = 0; pass < kPasses; ++pass)
+  {
+    std::size_t *offsets = &counts[pass * kBuckets];
+    if (offsets[digitOf(src[0], pass)] == n) { continue; } // every key has the same digit here
+
+    std::size_t sum = 0;
+    for (std::size_t d = 0; d < kBuckets; ++d)
+    {
+      std::size_t count = offsets[d];
+      offsets[d]        = sum;
+      sum += count;
+    }
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      dst[offsets[digitOf(src[i], pass)]++] = std::move(src[i]);
+    }
+    std::swap(src, dst);
+  }
+
+  if (src != arr.data())
+  {
+    std::move(src, src + n, arr.data());
+  }
+}
+
+template <typename T>
+void radixSort(std::vector<T> &arr, std::size_t num_threads = 1)
+{
+  radixSort(arr, [](const T &element) { return element; }, num_threads);
+}
+
+#endif // SORTING_RADIX_SORT_H
@@ -0,0 +1,2 @@
+
+#include "sorting/search_index/search_index.h"
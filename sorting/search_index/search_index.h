@@ -0,0 +1,183 @@
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "sorting/simd_sort/simd_sort.h"
+
+#ifndef SORTING_SEARCH_INDEX_H
+#define SORTING_SEARCH_INDEX_H
+
+/*
+Read-only search index over a fixed set of keys, for many unsorted probes against one large reference array (e.g.
+camera timestamps). `findPairsOptimized` needs both arrays sorted; this index answers each probe on its own.
+
+The keys are stored in Eytzinger (BFS) order: node k has children 2k and 2k + 1, so the first levels of every search
+share a few hot cache lines and a search touches one new cache line per level near the leaves. The descent is
+branchless, and each step prefetches the cache line holding the node's descendants log2(64 / sizeof(T)) levels down.
+The batched queries descend kSearchIndexBatch probes in lockstep, so their cache misses overlap.
+
+|property|description|
+|---|---|
+|Build|O(n log n) to sort, then O(n) to lay out.|
+|Query|O(log n) branchless steps; ranks match `std::lower_bound` on the sorted keys.|
+|Nearest|the predecessor and the lower bound are both on the search path, so nearest() costs no extra search.|
+|Space|the sorted keys, the Eytzinger copy and one rank per key.|
+*/
+
+// Probes that the batched queries descend together
+constexpr std::size_t kSearchIndexBatch = 16;
+
+template <typename T>
+class EytzingerIndex
+{
+ public:
+  // The keys need not be sorted
+  explicit EytzingerIndex(std::vector<T> keys) : sorted_(std::move(keys))
+  {
+    simdSort(sorted_);
+    const std::size_t n = sorted_.size();
+
+    // Align node 0 to a cache line, so the descendants of node k at depth log2(kLine) share one line
+    storage_.resize(n + 1 + kLine);
+    offset_ = 0;
+    if constexpr (64 % sizeof(T) == 0)
+    {
+      std::uintptr_t address = reinterpret_cast<std::uintptr_t>(storage_.data());
+      offset_                = (64 - address % 64) % 64 / sizeof(T);
+    }
+    ranks_.assign(n + 1, n);
+
+    // In-order walk of the implicit tree assigns the sorted keys to the nodes
+    std::size_t rank = 0;
+    std::vector<std::size_t> stack;
+    for (std::size_t k = 1; k <= n || !stack.empty();)
+    {
+      if (k <= n)
+      {
+        stack.push_back(k);
+        k *= 2;
+        continue;
+      }
+      k = stack.back();
+      stack.pop_back();
+      tree()[k] = sorted_[rank];
+      ranks_[k] = rank++;
+      k         = 2 * k + 1;
+    }
+  }
+
+  EytzingerIndex(EytzingerIndex &&)                 = default;
+  EytzingerIndex &operator=(EytzingerIndex &&)      = default;
+  EytzingerIndex(const EytzingerIndex &)            = delete; // a copied buffer would lose the cache-line alignment
+  EytzingerIndex &operator=(const EytzingerIndex &) = delete;
+
+  std::size_t size() const { return sorted_.size(); }
+  const std::vector<T> &sorted() const { return sorted_; }
+
+  // Rank of the first key not less than x, or size() if there is none
+  std::size_t lowerBound(const T &x) const { return ranks_[lowerBoundNode(descend(x))]; }
+
+  // Rank of the key nearest to x if it is within threshold, otherwise size(). Ties go to the smaller key.
+  std::size_t nearest(const T &x, const T &threshold) const { return nearestRank(x, threshold, descend(x)); }
+
+  std::vector<std::size_t> lowerBound(const std::vector<T> &queries) const
+  {
+    std::vector<std::size_t> ranks(queries.size());
+    batch(queries, [&](std::size_t i, std::size_t path) { ranks[i] = ranks_[lowerBoundNode(path)]; });
+    return ranks;
+  }
+
+  std::vector<std::size_t> nearest(const std::vector<T> &queries, const T &threshold) const
+  {
+    std::vector<std::size_t> ranks(queries.size());
+    batch(queries, [&](std::size_t i, std::size_t path) { ranks[i] = nearestRank(queries[i], threshold, path); });
+    return ranks;
+  }
+
+ private:
+  // Keys per cache line; prefetching node k * kLine fetches the descendants log2(kLine) levels down
+  static constexpr std::size_t kLine = sizeof(T) < 64 ? 64 / sizeof(T) : 1;
+
+  T *tree() { return storage_.data() + offset_; }
+  const T *tree() const { return storage_.data() + offset_; }
+
+  // One branchless step: left when the node is not less than x. Past the leaves the path stays where it is.
+  std::size_t step(std::size_t k, const T &x) const
+  {
+    const std::size_t n = sorted_.size();
+    __builtin_prefetch(tree() + std::min(k * kLine, n));
+    std::size_t next = 2 * k + (tree()[std::min(k, n)] < x);
+    return k <= n ? next : k;
+  }
+
+  // The path of the search: its bits are the turns taken, 1 for right
+  std::size_t descend(const T &x) const
+  {
+    std::size_t k = 1;
+    while (k <= sorted_.size())
+    {
+      k = step(k, x);
+    }
+    return k;
+  }
+
+  // The lower bound is the last node where the path turned left, the predecessor the last where it turned right;
+  // node 0 means there is none
+  static std::size_t lowerBoundNode(std::size_t path) { return path >> (__builtin_ctzll(~path) + 1); }
+  static std::size_t predecessorNode(std::size_t path) { return path >> (__builtin_ctzll(path) + 1); }
+
+  std::size_t nearestRank(const T &x, const T &threshold, std::size_t path) const
+  {
+    std::size_t below = predecessorNode(path), above = lowerBoundNode(path);
+    std::size_t best  = sorted_.size();
+    if (below != 0 && !(threshold < x - tree()[below])) { best = ranks_[below]; }
+    if (above != 0 && !(threshold < tree()[above] - x) && (below == 0 || tree()[above] - x < x - tree()[below]))
+    {
+      best = ranks_[above];
+    }
+    return best;
+  }
+
+  // Descend the queries kSearchIndexBatch at a time in lockstep and hand each finished path to visit(i, path)
+  template <typename Visit>
+  void batch(const std::vector<T> &queries, Visit visit) const
+  {
+    const std::size_t n = sorted_.size();
+    std::size_t depth   = 0;
+    while ((std::size_t(1) << depth) <= n)
+    {
+      ++depth;
+    }
+
+    std::size_t paths[kSearchIndexBatch];
+    for (std::size_t begin = 0; begin < queries.size(); begin += kSearchIndexBatch)
+    {
+      const std::size_t count = std::min(kSearchIndexBatch, queries.size() - begin);
+      for (std::size_t j = 0; j < count; ++j)
+      {
+        paths[j] = 1;
+      }
+      for (std::size_t level = 0; level < depth; ++level)
+      {
+        for (std::size_t j = 0; j < count; ++j)
+        {
+          paths[j] = step(paths[j], queries[begin + j]);
+        }
+      }
+      for (std::size_t j = 0; j < count; ++j)
+      {
+        visit(begin + j, paths[j]);
+      }
+    }
+  }
+
+  std::vector<T> sorted_;
+  std::vector<T> storage_;
+  std::size_t offset_ = 0;
+  std::vector<std::size_t> ranks_;
+};
+
+#endif // SORTING_SEARCH_INDEX_H
@@ -1,6 +1,10 @@
 
+#include <algorithm>
+#include <functional>
 #include <vector>
 
+#include "sorting/sort_view/sort_view.h"
+
 #ifndef SORTING_SELECT_SORT_H
 #define SORTING_SELECT_SORT_H
 
@@ -11,26 +15,26 @@
 |Not Stable|it does not preserve the relative order of equal elements.|
 */
 
-template <typename T>
-void selectSort(std::vector<T> &a)
+// Sort [first, last) of any random-access range by comp(proj(a), proj(b))
+template <typename RandomIt, typename Compare = std::less<>, typename Projection = SortIdentity>
+void selectSort(RandomIt first, RandomIt last, Compare comp = Compare(), Projection proj = Projection())
 {
-  int pos;  // 目前最小的数字的位置
-  int temp; // temp存最小数字
-  for (int i = 0; i < a.size(); i++)
+  auto less = projectedCompare(std::move(comp), std::move(proj));
+  for (RandomIt i = first; i != last; ++i)
   {
-    pos  = i;                              // 最小值位置
-    temp = a[i];                           // 最小值
-    for (int j = i + 1; j < a.size(); j++) // 查找最小的字符
+    RandomIt pos = i;                        // 目前最小的数字的位置
+    for (RandomIt j = i + 1; j != last; ++j) // 查找最小的字符
     {
-      if (a[j] < temp) // 新最小值出现
-      {
-        pos  = j; // 新的最小字符的位置
-        temp = a[j];
-      }
+      if (less(*j, *pos)) { pos = j; } // 新最小值出现
     }
-    a[pos] = a[i]; // 交换元素
-    a[i]   = temp; // 最小值置于最低位
+    if (pos != i) { std::iter_swap(pos, i); } // 最小值置于最低位
   }
 }
 
+template <typename T>
+void selectSort(std::vector<T> &a)
+{
+  selectSort(a.begin(), a.end());
+}
+
 #endif // SORTING_SELECT_SORT_H
\ No newline at end of file
@@ -0,0 +1,2 @@
+
+#include "sorting/simd_sort/simd_sort.h"
@@ -0,0 +1,768 @@
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "sorting/intro_sort/intro_sort.h"
+
+#ifndef SORTING_SIMD_SORT_H
+#define SORTING_SIMD_SORT_H
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define BMATH_SIMD_SORT_X86 1
+// GCC 12 reports the placeholder operands of some AVX-512 intrinsics as uninitialized
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+#define BMATH_SIMD_AVX2 __attribute__((target("avx2,popcnt")))
+#define BMATH_SIMD_AVX512 __attribute__((target("avx512f,avx2,popcnt")))
+#endif
+
+/*
+Vectorized partition and sort kernels for float, double, int32_t and int64_t keys.
+The instruction set is chosen at run time, so the library does not have to be built with -mavx2 or -mavx512f.
+
+|kernel|AVX2|AVX-512|
+|---|---|---|
+|partition|compare, then permute the vector with a lookup table so the lesser lanes come first; store it at both ends|compare, then compress-store the lesser lanes to the left end and the other lanes to the right end|
+|leaf sort|bitonic network over two 256-bit registers (16 x 32-bit or 8 x 64-bit keys)|bitonic network over two 512-bit registers (32 x 32-bit or 16 x 64-bit keys)|
+
+The partition is in place: one vector is buffered from each end, and the next vector is always read from the end with
+less free space, so both stores of a vector always land in already consumed slots.
+
+Other element types, and CPUs without AVX2, fall back to the generic templates. NaN keys are not supported, as with
+any `<` based sort.
+*/
+
+enum class SimdLevel
+{
+  kScalar = 0,
+  kAvx2   = 1,
+  kAvx512 = 2
+};
+
+// Best instruction set supported by this CPU, detected once
+inline SimdLevel simdLevel()
+{
+  static const SimdLevel level = []() {
+#ifdef BMATH_SIMD_SORT_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) { return SimdLevel::kAvx512; }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) { return SimdLevel::kAvx2; }
+#endif
+    return SimdLevel::kScalar;
+  }();
+  return level;
+}
+
+template <typename T>
+struct SimdSortSupported
+{
+#ifdef BMATH_SIMD_SORT_X86
+  static constexpr bool value = std::is_same<T, float>::value || std::is_same<T, double>::value
+                                || std::is_same<T, std::int32_t>::value || std::is_same<T, std::int64_t>::value;
+#else
+  static constexpr bool value = false;
+#endif
+};
+
+// Move the elements that are less than (or, with less_equal, not greater than) the pivot to the front of data[0, n)
+// and return how many there are
+template <typename T>
+std::size_t scalarPartition(T *data, std::size_t n, const T &pivot, bool less_equal)
+{
+  std::size_t store_index = 0;
+  for (std::size_t i = 0; i < n; i++)
+  {
+    if (less_equal ? !(pivot < data[i]) : data[i] < pivot)
+    {
+      std::swap(data[i], data[store_index]);
+      store_index++;
+    }
+  }
+  return store_index;
+}
+
+#ifdef BMATH_SIMD_SORT_X86
+
+constexpr std::size_t simdLog2(std::size_t n)
+{
+  return n > 1 ? 1 + simdLog2(n / 2) : 0;
+}
+
+// Bitonic network for kLanes keys held in a register of kWords 32-bit words.
+// Steps [0, kSortSteps) sort one register; steps [kSortSteps, kSteps) finish merging two registers.
+template <std::size_t kWords, std::size_t kLanes>
+struct SimdNetworkTables
+{
+  static constexpr std::size_t kLog       = simdLog2(kLanes);
+  static constexpr std::size_t kSortSteps = kLog * (kLog + 1) / 2;
+  static constexpr std::size_t kSteps     = kSortSteps + kLog;
+
+  std::int32_t partner[kSteps][kWords]  = {}; // word indices of the compare-exchange partner
+  std::int32_t take_max[kSteps][kWords] = {}; // -1 on the words of lanes that keep the maximum
+  unsigned take_max_bits[kSteps]        = {}; // the same per lane, as a bit mask
+  std::int32_t reverse[kWords]          = {};
+};
+
+template <std::size_t kWords, std::size_t kLanes>
+constexpr SimdNetworkTables<kWords, kLanes> makeSimdNetworkTables()
+{
+  SimdNetworkTables<kWords, kLanes> tables;
+  constexpr std::size_t words_per_lane = kWords / kLanes;
+
+  auto add_step = [&tables](std::size_t step, std::size_t i, std::size_t j, bool take_max) {
+    for (std::size_t w = 0; w < words_per_lane; ++w)
+    {
+      tables.partner[step][i * words_per_lane + w]  = static_cast<std::int32_t>((i ^ j) * words_per_lane + w);
+      tables.take_max[step][i * words_per_lane + w] = take_max ? -1 : 0;
+    }
+    tables.take_max_bits[step] |= take_max ? 1u << i : 0u;
+  };
+
+  std::size_t step = 0;
+  // Bitonic sort of one register: blocks of size k alternate between ascending and descending
+  for (std::size_t k = 2; k <= kLanes; k <<= 1)
+  {
+    for (std::size_t j = k >> 1; j > 0; j >>= 1, ++step)
+    {
+      for (std::size_t i = 0; i < kLanes; ++i)
+      {
+        bool ascending = (i & k) == 0;
+        add_step(step, i, j, ascending == ((i & j) != 0));
+      }
+    }
+  }
+  // Half-cleaners that sort a bitonic register in ascending order
+  for (std::size_t j = kLanes >> 1; j > 0; j >>= 1, ++step)
+  {
+    for (std::size_t i = 0; i < kLanes; ++i)
+    {
+      add_step(step, i, j, (i & j) != 0);
+    }
+  }
+  for (std::size_t i = 0; i < kLanes; ++i)
+  {
+    for (std::size_t w = 0; w < words_per_lane; ++w)
+    {
+      tables.reverse[i * words_per_lane + w] = static_cast<std::int32_t>((kLanes - 1 - i) * words_per_lane + w);
+    }
+  }
+  return tables;
+}
+
+template <std::size_t kWords, std::size_t kLanes>
+inline constexpr SimdNetworkTables<kWords, kLanes> kSimdNetworkTables = makeSimdNetworkTables<kWords, kLanes>();
+
+// AVX2 has no compress-store: compact[mask] moves the lanes whose mask bit is set to the front, the others behind
+template <std::size_t kWords, std::size_t kLanes>
+struct SimdCompactTable
+{
+  std::int32_t compact[1u << kLanes][kWords] = {};
+};
+
+template <std::size_t kWords, std::size_t kLanes>
+constexpr SimdCompactTable<kWords, kLanes> makeSimdCompactTable()
+{
+  SimdCompactTable<kWords, kLanes> table;
+  constexpr std::size_t words_per_lane = kWords / kLanes;
+  for (std::size_t mask = 0; mask < (1u << kLanes); ++mask)
+  {
+    std::size_t position = 0;
+    for (int selected = 1; selected >= 0; --selected)
+    {
+      for (std::size_t i = 0; i < kLanes; ++i)
+      {
+        if (((mask >> i) & 1u) != static_cast<std::size_t>(selected)) { continue; }
+        for (std::size_t w = 0; w < words_per_lane; ++w)
+        {
+          table.compact[mask][position * words_per_lane + w] = static_cast<std::int32_t>(i * words_per_lane + w);
+        }
+        ++position;
+      }
+    }
+  }
+  return table;
+}
+
+template <std::size_t kWords, std::size_t kLanes>
+inline constexpr SimdCompactTable<kWords, kLanes> kSimdCompactTable = makeSimdCompactTable<kWords, kLanes>();
+
+/* AVX2 traits */
+
+template <typename T>
+struct SimdAvx2Traits;
+
+template <>
+struct SimdAvx2Traits<float>
+{
+  using T                              = float;
+  using V                              = __m256;
+  static constexpr std::size_t kLanes = 8;
+  static constexpr std::size_t kWords = 8;
+
+  static T padding() { return std::numeric_limits<T>::infinity(); }
+  static BMATH_SIMD_AVX2 V load(const T *p) { return _mm256_loadu_ps(p); }
+  static BMATH_SIMD_AVX2 void store(T *p, V v) { _mm256_storeu_ps(p, v); }
+  static BMATH_SIMD_AVX2 V set1(T x) { return _mm256_set1_ps(x); }
+  static BMATH_SIMD_AVX2 unsigned lessMask(V v, V pivot, bool less_equal)
+  {
+    return less_equal ? _mm256_movemask_ps(_mm256_cmp_ps(v, pivot, _CMP_LE_OQ))
+                      : _mm256_movemask_ps(_mm256_cmp_ps(v, pivot, _CMP_LT_OQ));
+  }
+  static BMATH_SIMD_AVX2 V min(V a, V b) { return _mm256_min_ps(a, b); }
+  static BMATH_SIMD_AVX2 V max(V a, V b) { return _mm256_max_ps(a, b); }
+  static BMATH_SIMD_AVX2 V permute(V v, const std::int32_t *index)
+  {
+    return _mm256_permutevar8x32_ps(v, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(index)));
+  }
+  static BMATH_SIMD_AVX2 V blend(V a, V b, const std::int32_t *take_b)
+  {
+    return _mm256_blendv_ps(a, b, _mm256_castsi256_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(take_b))));
+  }
+};
+
+template <>
+struct SimdAvx2Traits<double>
+{
+  using T                              = double;
+  using V                              = __m256d;
+  static constexpr std::size_t kLanes = 4;
+  static constexpr std::size_t kWords = 8;
+
+  static T padding() { return std::numeric_limits<T>::infinity(); }
+  static BMATH_SIMD_AVX2 V load(const T *p) { return _mm256_loadu_pd(p); }
+  static BMATH_SIMD_AVX2 void store(T *p, V v) { _mm256_storeu_pd(p, v); }
+  static BMATH_SIMD_AVX2 V set1(T x) { return _mm256_set1_pd(x); }
+  static BMATH_SIMD_AVX2 unsigned lessMask(V v, V pivot, bool less_equal)
+  {
+    return less_equal ? _mm256_movemask_pd(_mm256_cmp_pd(v, pivot, _CMP_LE_OQ))
+                      : _mm256_movemask_pd(_mm256_cmp_pd(v, pivot, _CMP_LT_OQ));
+  }
+  static BMATH_SIMD_AVX2 V min(V a, V b) { return _mm256_min_pd(a, b); }
+  static BMATH_SIMD_AVX2 V max(V a, V b) { return _mm256_max_pd(a, b); }
+  static BMATH_SIMD_AVX2 V permute(V v, const std::int32_t *index)
+  {
+    __m256i words = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(index));
+    return _mm256_castps_pd(_mm256_permutevar8x32_ps(_mm256_castpd_ps(v), words));
+  }
+  static BMATH_SIMD_AVX2 V blend(V a, V b, const std::int32_t *take_b)
+  {
+    return _mm256_blendv_pd(a, b, _mm256_castsi256_pd(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(take_b))));
+  }
+};
+
+template <>
+struct SimdAvx2Traits<std::int32_t>
+{
+  using T                              = std::int32_t;
+  using V                              = __m256i;
+  static constexpr std::size_t kLanes = 8;
+  static constexpr std::size_t kWords = 8;
+
+  static T padding() { return std::numeric_limits<T>::max(); }
+  static BMATH_SIMD_AVX2 V load(const T *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+  static BMATH_SIMD_AVX2 void store(T *p, V v) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); }
+  static BMATH_SIMD_AVX2 V set1(T x) { return _mm256_set1_epi32(x); }
+  static BMATH_SIMD_AVX2 unsigned lessMask(V v, V pivot, bool less_equal)
+  {
+    return less_equal ? ~_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(v, pivot))) & 0xFFu
+                      : _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(pivot, v)));
+  }
+  static BMATH_SIMD_AVX2 V min(V a, V b) { return _mm256_min_epi32(a, b); }
+  static BMATH_SIMD_AVX2 V max(V a, V b) { return _mm256_max_epi32(a, b); }
+  static BMATH_SIMD_AVX2 V permute(V v, const std::int32_t *index)
+  {
+    return _mm256_permutevar8x32_epi32(v, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(index)));
+  }
+  static BMATH_SIMD_AVX2 V blend(V a, V b, const std::int32_t *take_b)
+  {
+    return _mm256_blendv_epi8(a, b, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(take_b)));
+  }
+};
+
+template <>
+struct SimdAvx2Traits<std::int64_t>
+{
+  using T                              = std::int64_t;
+  using V                              = __m256i;
+  static constexpr std::size_t kLanes = 4;
+  static constexpr std::size_t kWords = 8;
+
+  static T padding() { return std::numeric_limits<T>::max(); }
+  static BMATH_SIMD_AVX2 V load(const T *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+  static BMATH_SIMD_AVX2 void store(T *p, V v) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); }
+  static BMATH_SIMD_AVX2 V set1(T x) { return _mm256_set1_epi64x(x); }
+  static BMATH_SIMD_AVX2 unsigned lessMask(V v, V pivot, bool less_equal)
+  {
+    return less_equal ? ~_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(v, pivot))) & 0xFu
+                      : _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(pivot, v)));
+  }
+  static BMATH_SIMD_AVX2 V min(V a, V b) { return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b)); }
+  static BMATH_SIMD_AVX2 V max(V a, V b) { return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b)); }
+  static BMATH_SIMD_AVX2 V permute(V v, const std::int32_t *index)
+  {
+    return _mm256_permutevar8x32_epi32(v, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(index)));
+  }
+  static BMATH_SIMD_AVX2 V blend(V a, V b, const std::int32_t *take_b)
+  {
+    return _mm256_blendv_epi8(a, b, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(take_b)));
+  }
+};
+
+/* AVX-512 traits */
+
+template <typename T>
+struct SimdAvx512Traits;
+
+template <>
+struct SimdAvx512Traits<float>
+{
+  using T                              = float;
+  using V                              = __m512;
+  static constexpr std::size_t kLanes = 16;
+  static constexpr std::size_t kWords = 16;
+
+  static T padding() { return std::numeric_limits<T>::infinity(); }
+  static BMATH_SIMD_AVX512 V load(const T *p) { return _mm512_loadu_ps(p); }
+  static BMATH_SIMD_AVX512 void store(T *p, V v) { _mm512_storeu_ps(p, v); }
+  static BMATH_SIMD_AVX512 V set1(T x) { return _mm512_set1_ps(x); }
+  static BMATH_SIMD_AVX512 unsigned lessMask(V v, V pivot, bool less_equal)
+  {
+    return less_equal ? _mm512_cmp_ps_mask(v, pivot, _CMP_LE_OQ) : _mm512_cmp_ps_mask(v, pivot, _CMP_LT_OQ);
+  }
+  static BMATH_SIMD_AVX512 void compressStore(T *p, unsigned mask, V v) { _mm512_mask_compressstoreu_ps(p, static_cast<__mmask16>(mask), v); }
+  static BMATH_SIMD_AVX512 V min(V a, V b) { return _mm512_min_ps(a, b); }
+  static BMATH_SIMD_AVX512 V max(V a, V b) { return _mm512_max_ps(a, b); }
+  static BMATH_SIMD_AVX512 V permute(V v, const std::int32_t *index) { return _mm512_permutexvar_ps(_mm512_loadu_si512(index), v); }
+  static BMATH_SIMD_AVX512 V blend(V a, V b, unsigned take_b) { return _mm512_mask_blend_ps(static_cast<__mmask16>(take_b), a, b); }
+};
+
+template <>
+struct SimdAvx512Traits<double>
+{
+  using T                              = double;
+  using V                              = __m512d;
+  static constexpr std::size_t kLanes = 8;
+  static constexpr std::size_t kWords = 16;
+
+  static T padding() { return std::numeric_limits<T>::infinity(); }
+  static BMATH_SIMD_AVX512 V load(const T *p) { return _mm512_loadu_pd(p); }
+  static BMATH_SIMD_AVX512 void store(T *p, V v) { _mm512_storeu_pd(p, v); }
+  static BMATH_SIMD_AVX512 V set1(T x) { return _mm512_set1_pd(x); }
+  static BMATH_SIMD_AVX512 unsigned lessMask(V v, V pivot, bool less_equal)
+  {
+    return less_equal ? _mm512_cmp_pd_mask(v, pivot, _CMP_LE_OQ) : _mm512_cmp_pd_mask(v, pivot, _CMP_LT_OQ);
+  }
+  static BMATH_SIMD_AVX512 void compressStore(T *p, unsigned mask, V v) { _mm512_mask_compressstoreu_pd(p, static_cast<__mmask8>(mask), v); }
+  static BMATH_SIMD_AVX512 V min(V a, V b) { return _mm512_min_pd(a, b); }
+  static BMATH_SIMD_AVX512 V max(V a, V b) { return _mm512_max_pd(a, b); }
+  static BMATH_SIMD_AVX512 V permute(V v, const std::int32_t *index)
+  {
+    return _mm512_castsi512_pd(_mm512_permutexvar_epi32(_mm512_loadu_si512(index), _mm512_castpd_si512(v)));
+  }
+  static BMATH_SIMD_AVX512 V blend(V a, V b, unsigned take_b) { return _mm512_mask_blend_pd(static_cast<__mmask8>(take_b), a, b); }
+};
+
+template <>
+struct SimdAvx512Traits<std::int32_t>
+{
+  using T                              = std::int32_t;
+  using V                              = __m512i;
+  static constexpr std::size_t kLanes = 16;
+  static constexpr std::size_t kWords = 16;
+
+  static T padding() { return std::numeric_limits<T>::max(); }
+  static BMATH_SIMD_AVX512 V load(const T *p) { return _mm512_loadu_si512(p); }
+  static BMATH_SIMD_AVX512 void store(T *p, V v) { _mm512_storeu_si512(p, v); }
+  static BMATH_SIMD_AVX512 V set1(T x) { return _mm512_set1_epi32(x); }
+  static BMATH_SIMD_AVX512 unsigned lessMask(V v, V pivot, bool less_equal)
+  {
+    return less_equal ? _mm512_cmple_epi32_mask(v, pivot) : _mm512_cmplt_epi32_mask(v, pivot);
+  }
+  static BMATH_SIMD_AVX512 void compressStore(T *p, unsigned mask, V v) { _mm512_mask_compressstoreu_epi32(p, static_cast<__mmask16>(mask), v); }
+  static BMATH_SIMD_AVX512 V min(V a, V b) { return _mm512_min_epi32(a, b); }
+  static BMATH_SIMD_AVX512 V max(V a, V b) { return _mm512_max_epi32(a, b); }
+  static BMATH_SIMD_AVX512 V permute(V v, const std::int32_t *index) { return _mm512_permutexvar_epi32(_mm512_loadu_si512(index), v); }
+  static BMATH_SIMD_AVX512 V blend(V a, V b, unsigned take_b) { return _mm512_mask_blend_epi32(static_cast<__mmask16>(take_b), a, b); }
+};
+
+template <>
+struct SimdAvx512Traits<std::int64_t>
+{
+  using T                              = std::int64_t;
+  using V                              = __m512i;
+  static constexpr std::size_t kLanes = 8;
+  static constexpr std::size_t kWords = 16;
+
+  static T padding() { return std::numeric_limits<T>::max(); }
+  static BMATH_SIMD_AVX512 V load(const T *p) { return _mm512_loadu_si512(p); }
+  static BMATH_SIMD_AVX512 void store(T *p, V v) { _mm512_storeu_si512(p, v); }
+  static BMATH_SIMD_AVX512 V set1(T x) { return _mm512_set1_epi64(x); }
+  static BMATH_SIMD_AVX512 unsigned lessMask(V v, V pivot, bool less_equal)
+  {
+    return less_equal ? _mm512_cmple_epi64_mask(v, pivot) : _mm512_cmplt_epi64_mask(v, pivot);
+  }
+  static BMATH_SIMD_AVX512 void compressStore(T *p, unsigned mask, V v) { _mm512_mask_compressstoreu_epi64(p, static_cast<__mmask8>(mask), v); }
+  static BMATH_SIMD_AVX512 V min(V a, V b) { return _mm512_min_epi64(a, b); }
+  static BMATH_SIMD_AVX512 V max(V a, V b) { return _mm512_max_epi64(a, b); }
+  static BMATH_SIMD_AVX512 V permute(V v, const std::int32_t *index) { return _mm512_permutexvar_epi32(_mm512_loadu_si512(index), v); }
+  static BMATH_SIMD_AVX512 V blend(V a, V b, unsigned take_b) { return _mm512_mask_blend_epi64(static_cast<__mmask8>(take_b), a, b); }
+};
+
+/* AVX2 kernels */
+
+// Partition one vector: the lesser lanes go to data[write_left, ...), the others to data[..., write_right).
+// Both stores write a full vector, so at least kLanes free slots must be available at each end.
+template <typename Traits>
+BMATH_SIMD_AVX2 void simdPartitionVectorAvx2(typename Traits::T *data, typename Traits::V v, typename Traits::V pivot,
+                                             bool less_equal, std::size_t &write_left, std::size_t &write_right)
+{
+  constexpr std::size_t W = Traits::kLanes;
+  unsigned mask           = Traits::lessMask(v, pivot, less_equal);
+  typename Traits::V packed = Traits::permute(v, kSimdCompactTable<Traits::kWords, W>.compact[mask]);
+  Traits::store(data + write_left, packed);
+  Traits::store(data + write_right - W, packed);
+  std::size_t count = static_cast<std::size_t>(__builtin_popcount(mask));
+  write_left += count;
+  write_right -= W - count;
+}
+
+template <typename Traits>
+BMATH_SIMD_AVX2 std::size_t simdPartitionAvx2(typename Traits::T *data, std::size_t n, typename Traits::T pivot, bool less_equal)
+{
+  using T                 = typename Traits::T;
+  using V                 = typename Traits::V;
+  constexpr std::size_t W = Traits::kLanes;
+  if (n < 2 * W) { return scalarPartition(data, n, pivot, less_equal); }
+
+  const V p     = Traits::set1(pivot);
+  const V left  = Traits::load(data);
+  const V right = Traits::load(data + n - W);
+
+  std::size_t read_left = W, read_right = n - W;
+  std::size_t write_left = 0, write_right = n;
+  while (read_right - read_left >= W)
+  {
+    V v;
+    if (read_left - write_left <= write_right - read_right)
+    {
+      v = Traits::load(data + read_left);
+      read_left += W;
+    }
+    else
+    {
+      read_right -= W;
+      v = Traits::load(data + read_right);
+    }
+    simdPartitionVectorAvx2<Traits>(data, v, p, less_equal, write_left, write_right);
+  }
+
+  // Everything left is held in registers or in tail, so [write_left, write_right) is free
+  T tail[W];
+  std::size_t tail_size = read_right - read_left;
+  std::copy(data + read_left, data + read_right, tail);
+  simdPartitionVectorAvx2<Traits>(data, left, p, less_equal, write_left, write_right);
+  for (std::size_t i = 0; i < tail_size; i++)
+  {
+    if (less_equal ? tail[i] <= pivot : tail[i] < pivot) { data[write_left++] = tail[i]; }
+    else { data[--write_right] = tail[i]; }
+  }
+  // Exactly W free slots remain, so both stores write the same window
+  simdPartitionVectorAvx2<Traits>(data, right, p, less_equal, write_left, write_right);
+  return write_left;
+}
+
+template <typename Traits>
+BMATH_SIMD_AVX2 typename Traits::V simdExchangeAvx2(typename Traits::V v, std::size_t step)
+{
+  const auto &tables   = kSimdNetworkTables<Traits::kWords, Traits::kLanes>;
+  typename Traits::V w = Traits::permute(v, tables.partner[step]);
+  return Traits::blend(Traits::min(v, w), Traits::max(v, w), tables.take_max[step]);
+}
+
+// Sort data[0, n) with n <= 2 * kLanes in registers
+template <typename Traits>
+BMATH_SIMD_AVX2 void simdNetworkSortAvx2(typename Traits::T *data, std::size_t n)
+{
+  using T                 = typename Traits::T;
+  using V                 = typename Traits::V;
+  using Tables            = SimdNetworkTables<Traits::kWords, Traits::kLanes>;
+  constexpr std::size_t W = Traits::kLanes;
+
+  T buffer[2 * W];
+  std::fill(buffer + n, buffer + 2 * W, Traits::padding());
+  std::copy(data, data + n, buffer);
+
+  V a = Traits::load(buffer);
+  for (std::size_t s = 0; s < Tables::kSortSteps; s++)
+  {
+    a = simdExchangeAvx2<Traits>(a, s);
+  }
+  if (n > W)
+  {
+    V b = Traits::load(buffer + W);
+    for (std::size_t s = 0; s < Tables::kSortSteps; s++)
+    {
+      b = simdExchangeAvx2<Traits>(b, s);
+    }
+    b    = Traits::permute(b, kSimdNetworkTables<Traits::kWords, W>.reverse);
+    V lo = Traits::min(a, b);
+    V hi = Traits::max(a, b);
+    for (std::size_t s = Tables::kSortSteps; s < Tables::kSteps; s++)
+    {
+      lo = simdExchangeAvx2<Traits>(lo, s);
+      hi = simdExchangeAvx2<Traits>(hi, s);
+    }
+    Traits::store(buffer + W, hi);
+    a = lo;
+  }
+  Traits::store(buffer, a);
+  std::copy(buffer, buffer + n, data);
+}
+
+/* AVX-512 kernels */
+
+// Partition one vector with compress-stores, which write only the selected lanes
+template <typename Traits>
+BMATH_SIMD_AVX512 void simdPartitionVectorAvx512(typename Traits::T *data, typename Traits::V v, typename Traits::V pivot,
+                                                 bool less_equal, std::size_t &write_left, std::size_t &write_right)
+{
+  constexpr std::size_t W = Traits::kLanes;
+  unsigned mask           = Traits::lessMask(v, pivot, less_equal);
+  std::size_t count       = static_cast<std::size_t>(__builtin_popcount(mask));
+  Traits::compressStore(data + write_left, mask, v);
+  Traits::compressStore(data + write_right - (W - count), ~mask & ((1u << W) - 1), v);
+  write_left += count;
+  write_right -= W - count;
+}
+
+template <typename Traits>
+BMATH_SIMD_AVX512 std::size_t simdPartitionAvx512(typename Traits::T *data, std::size_t n, typename Traits::T pivot, bool less_equal)
+{
+  using T                 = typename Traits::T;
+  using V                 = typename Traits::V;
+  constexpr std::size_t W = Traits::kLanes;
+  if (n < 2 * W) { return scalarPartition(data, n, pivot, less_equal); }
+
+  const V p     = Traits::set1(pivot);
+  const V left  = Traits::load(data);
+  const V right = Traits::load(data + n - W);
+
+  std::size_t read_left = W, read_right = n - W;
+  std::size_t write_left = 0, write_right = n;
+  while (read_right - read_left >= W)
+  {
+    V v;
+    if (read_left - write_left <= write_right - read_right)
+    {
+      v = Traits::load(data + read_left);
+      read_left += W;
+    }
+    else
+    {
+      read_right -= W;
+      v = Traits::load(data + read_right);
+    }
+    simdPartitionVectorAvx512<Traits>(data, v, p, less_equal, write_left, write_right);
+  }
+
+  T tail[W];
+  std::size_t tail_size = read_right - read_left;
+  std::copy(data + read_left, data + read_right, tail);
+  simdPartitionVectorAvx512<Traits>(data, left, p, less_equal, write_left, write_right);
+  for (std::size_t i = 0; i < tail_size; i++)
+  {
+    if (less_equal ? tail[i] <= pivot : tail[i] < pivot) { data[write_left++] = tail[i]; }
+    else { data[--write_right] = tail[i]; }
+  }
+  simdPartitionVectorAvx512<Traits>(data, right, p, less_equal, write_left, write_right);
+  return write_left;
+}
+
+template <typename Traits>
+BMATH_SIMD_AVX512 typename Traits::V simdExchangeAvx512(typename Traits::V v, std::size_t step)
+{
+  const auto &tables   = kSimdNetworkTables<Traits::kWords, Traits::kLanes>;
+  typename Traits::V w = Traits::permute(v, tables.partner[step]);
+  return Traits::blend(Traits::min(v, w), Traits::max(v, w), tables.take_max_bits[step]);
+}
+
+template <typename Traits>
+BMATH_SIMD_AVX512 void simdNetworkSortAvx512(typename Traits::T *data, std::size_t n)
+{
+  using T                 = typename Traits::T;
+  using V                 = typename Traits::V;
+  using Tables            = SimdNetworkTables<Traits::kWords, Traits::kLanes>;
+  constexpr std::size_t W = Traits::kLanes;
+
+  T buffer[2 * W];
+  std::fill(buffer + n, buffer + 2 * W, Traits::padding());
+  std::copy(data, data + n, buffer);
+
+  V a = Traits::load(buffer);
+  for (std::size_t s = 0; s < Tables::kSortSteps; s++)
+  {
+    a = simdExchangeAvx512<Traits>(a, s);
+  }
+  if (n > W)
+  {
+    V b = Traits::load(buffer + W);
+    for (std::size_t s = 0; s < Tables::kSortSteps; s++)
+    {
+      b = simdExchangeAvx512<Traits>(b, s);
+    }
+    b    = Traits::permute(b, kSimdNetworkTables<Traits::kWords, W>.reverse);
+    V lo = Traits::min(a, b);
+    V hi = Traits::max(a, b);
+    for (std::size_t s = Tables::kSortSteps; s < Tables::kSteps; s++)
+    {
+      lo = simdExchangeAvx512<Traits>(lo, s);
+      hi = simdExchangeAvx512<Traits>(hi, s);
+    }
+    Traits::store(buffer + W, hi);
+    a = lo;
+  }
+  Traits::store(buffer, a);
+  std::copy(buffer, buffer + n, data);
+}
+
+#endif // BMATH_SIMD_SORT_X86
+
+/* dispatch */
+
+// Partition data[0, n) so the elements less than (with less_equal: not greater than) the pivot come first.
+// Returns how many there are. level is clamped to what the CPU supports.
+template <typename T>
+std::size_t simdPartition(T *data, std::size_t n, const T &pivot, bool less_equal = false, SimdLevel level = simdLevel())
+{
+#ifdef BMATH_SIMD_SORT_X86
+  if constexpr (SimdSortSupported<T>::value)
+  {
+    level = std::min(level, simdLevel());
+    if (level == SimdLevel::kAvx512) { return simdPartitionAvx512<SimdAvx512Traits<T>>(data, n, pivot, less_equal); }
+    if (level == SimdLevel::kAvx2) { return simdPartitionAvx2<SimdAvx2Traits<T>>(data, n, pivot, less_equal); }
+  }
+#endif
+  return scalarPartition(data, n, pivot, less_equal);
+}
+
+// Number of keys the leaf sorting network handles at the given level (0 for scalar)
+template <typename T>
+std::size_t simdLeafSize(SimdLevel level = simdLevel())
+{
+#ifdef BMATH_SIMD_SORT_X86
+  if constexpr (SimdSortSupported<T>::value)
+  {
+    level = std::min(level, simdLevel());
+    if (level == SimdLevel::kAvx512) { return 2 * SimdAvx512Traits<T>::kLanes; }
+    if (level == SimdLevel::kAvx2) { return 2 * SimdAvx2Traits<T>::kLanes; }
+  }
+#endif
+  return 0;
+}
+
+// Sort data[0, n) with an in-register sorting network; n must not exceed simdLeafSize<T>(level)
+template <typename T>
+void simdNetworkSort(T *data, std::size_t n, SimdLevel level = simdLevel())
+{
+#ifdef BMATH_SIMD_SORT_X86
+  if constexpr (SimdSortSupported<T>::value)
+  {
+    level = std::min(level, simdLevel());
+    if (level == SimdLevel::kAvx512)
+    {
+      simdNetworkSortAvx512<SimdAvx512Traits<T>>(data, n);
+      return;
+    }
+    if (level == SimdLevel::kAvx2)
+    {
+      simdNetworkSortAvx2<SimdAvx2Traits<T>>(data, n);
+      return;
+    }
+  }
+#endif
+  std::sort(data, data + n);
+}
+
+// Quicksort with vectorized partitions and network-sorted leaves. Keys equal to a pivot that is also the minimum
+// of its range are split off in a second pass, so duplicate-heavy inputs stay O(n log n); heapsort caps the depth.
+template <typename T>
+void simdSort(std::vector<T> &arr, SimdLevel level = simdLevel())
+{
+  const std::size_t leaf = simdLeafSize<T>(level);
+  if (leaf == 0)
+  {
+    introSort(arr);
+    return;
+  }
+
+  std::size_t depth_limit = 0;
+  for (std::size_t n = arr.size(); n > 1; n >>= 1)
+  {
+    depth_limit += 2;
+  }
+
+  struct Range
+  {
+    std::size_t begin, end, depth; // half-open [begin, end)
+  };
+  std::vector<Range> stack;
+  stack.push_back({0, arr.size(), depth_limit});
+
+  while (!stack.empty())
+  {
+    Range range = stack.back();
+    stack.pop_back();
+
+    while (range.end - range.begin > leaf)
+    {
+      if (range.depth == 0)
+      {
+        heapSort(arr, range.begin, range.end - 1);
+        break;
+      }
+      --range.depth;
+
+      std::size_t n   = range.end - range.begin;
+      const T pivot   = arr[choosePivot(arr, range.begin, range.end - 1)];
+      std::size_t mid = range.begin + simdPartition(arr.data() + range.begin, n, pivot, false, level);
+      if (mid == range.begin)
+      {
+        // The pivot is the minimum: gather the keys equal to it, which are already in place
+        std::size_t equal = simdPartition(arr.data() + range.begin, n, pivot, true, level);
+        if (equal == 0)
+        {
+          heapSort(arr, range.begin, range.end - 1); // unordered keys such as NaN
+          break;
+        }
+        range.begin += equal;
+        continue;
+      }
+
+      Range left{range.begin, mid, range.depth};
+      Range right{mid, range.end, range.depth};
+      if (mid - range.begin < range.end - mid)
+      {
+        stack.push_back(right);
+        range = left;
+      }
+      else
+      {
+        stack.push_back(left);
+        range = right;
+      }
+    }
+
+    if (range.end - range.begin > 1 && range.end - range.begin <= leaf)
+    {
+      simdNetworkSort(arr.data() + range.begin, range.end - range.begin, level);
+    }
+  }
+}
+
+#endif // SORTING_SIMD_SORT_H
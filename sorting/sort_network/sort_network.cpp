@@ -0,0 +1,2 @@
+
+#include "sorting/sort_network/sort_network.h"
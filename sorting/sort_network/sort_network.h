@@ -0,0 +1,249 @@
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "sorting/insert_sort/insert_sort.h"
+
+#ifndef SORTING_SORT_NETWORK_H
+#define SORTING_SORT_NETWORK_H
+
+/*
+Sorting and selection networks for arrays of up to kSortNetworkMaxSize elements, generated at compile time.
+
+The sorting networks are Batcher's merge-exchange networks (Knuth, TAOCP 5.2.2, Algorithm M), which take any n, not
+only powers of two. They are size-optimal up to n = 8 (19 comparators) and within 6% of the best known networks up
+to 32 (63 against 60 comparators for n = 16). A selection network keeps only the comparators of the sorting network
+that can still move a value onto output K; the median network selects output (N - 1) / 2, the lower median, like
+`medianOfMediansRange`, with 8 comparators for n = 5 and 53 for n = 16.
+
+Every comparator is expanded inline from a constexpr table. For arithmetic types the compare-exchange is a branchless
+min/max (minsd/maxsd or cmov), so the time does not depend on the data; other types swap on operator<. NaN keys are
+not supported, as with `simdSort`.
+
+|property|description|
+|---|---|
+|Time Complexity|a fixed number of compare-exchanges per n: 9 for n = 5, 19 for n = 8, 63 for n = 16, 191 for n = 32.|
+|Space Complexity|O(1).|
+|Constexpr|`sortNetwork` and `medianNetwork` on std::array can run in constant expressions.|
+|Not Stable|it does not preserve the relative order of equal elements.|
+*/
+
+// Largest array with a generated network
+constexpr std::size_t kSortNetworkMaxSize = 32;
+
+struct SortComparator
+{
+  std::uint8_t first, second; // first < second; the smaller value ends at first
+};
+
+// Visit the comparators of the n-input merge-exchange network in order
+template <typename Visit>
+constexpr void mergeExchangeNetwork(std::size_t n, Visit &&visit)
+{
+  if (n < 2) { return; }
+  std::size_t t = 0;
+  while ((std::size_t(1) << t) < n)
+  {
+    ++t;
+  }
+  for (std::size_t p = std::size_t(1) << (t - 1); p > 0; p >>= 1)
+  {
+    std::size_t q = std::size_t(1) << (t - 1), r = 0, d = p;
+    while (true)
+    {
+      for (std::size_t i = 0; i + d < n; ++i)
+      {
+        if ((i & p) == r) { visit(i, i + d); }
+      }
+      if (q == p) { break; }
+      d = q - p;
+      q >>= 1;
+      r = p;
+    }
+  }
+}
+
+constexpr std::size_t mergeExchangeSize(std::size_t n)
+{
+  std::size_t size = 0;
+  mergeExchangeNetwork(n, [&size](std::size_t, std::size_t) { ++size; });
+  return size;
+}
+
+template <std::size_t N>
+struct SortNetwork
+{
+  static_assert(N <= kSortNetworkMaxSize, "sorting networks are generated up to kSortNetworkMaxSize inputs");
+
+  static constexpr std::size_t kSize = mergeExchangeSize(N);
+
+  static constexpr std::array<SortComparator, kSize> make()
+  {
+    std::array<SortComparator, kSize> comparators{};
+    std::size_t size = 0;
+    mergeExchangeNetwork(N, [&](std::size_t i, std::size_t j) {
+      comparators[size++] = {static_cast<std::uint8_t>(i), static_cast<std::uint8_t>(j)};
+    });
+    return comparators;
+  }
+
+  static constexpr std::array<SortComparator, kSize> kComparators = make();
+};
+
+// The comparators of SortNetwork<N> that can move a value onto output K, found by walking the network backwards
+template <std::size_t N, std::size_t K>
+struct SelectNetwork
+{
+  static_assert(K < N, "the selected output must be one of the N outputs");
+  using Full = SortNetwork<N>;
+
+  static constexpr std::array<bool, Full::kSize> keep()
+  {
+    std::array<bool, Full::kSize> kept{};
+    std::array<bool, N> needed{};
+    needed[K] = true;
+    for (std::size_t c = Full::kSize; c-- > 0;)
+    {
+      const SortComparator comparator = Full::kComparators[c];
+      if (needed[comparator.first] || needed[comparator.second])
+      {
+        kept[c]                   = true;
+        needed[comparator.first]  = true;
+        needed[comparator.second] = true;
+      }
+    }
+    return kept;
+  }
+
+  static constexpr std::size_t count()
+  {
+    std::size_t size                         = 0;
+    const std::array<bool, Full::kSize> kept = keep();
+    for (std::size_t c = 0; c < Full::kSize; ++c)
+    {
+      size += kept[c] ? 1 : 0;
+    }
+    return size;
+  }
+
+  static constexpr std::size_t kSize = count();
+
+  static constexpr std::array<SortComparator, kSize> make()
+  {
+    std::array<SortComparator, kSize> comparators{};
+    const std::array<bool, Full::kSize> kept = keep();
+    std::size_t size                         = 0;
+    for (std::size_t c = 0; c < Full::kSize; ++c)
+    {
+      if (kept[c]) { comparators[size++] = Full::kComparators[c]; }
+    }
+    return comparators;
+  }
+
+  static constexpr std::array<SortComparator, kSize> kComparators = make();
+};
+
+template <std::size_t N>
+using MedianNetwork = SelectNetwork<N, (N - 1) / 2>;
+
+// Order a and b: branchless min/max for arithmetic types, a conditional swap otherwise
+template <typename T>
+constexpr void compareExchange(T &a, T &b)
+{
+  if constexpr (std::is_arithmetic<T>::value)
+  {
+    // Two separate selections compile to minsd/maxsd or cmov; one shared condition would become a branch
+    const T low  = b < a ? b : a;
+    const T high = a < b ? b : a;
+    a            = low;
+    b            = high;
+  }
+  else if (b < a)
+  {
+    T temp = std::move(a);
+    a      = std::move(b);
+    b      = std::move(temp);
+  }
+}
+
+// Expand every comparator of Network inline
+template <typename Network, typename T, std::size_t... I>
+constexpr void applyNetwork(T *data, std::index_sequence<I...>)
+{
+  (compareExchange(data[Network::kComparators[I].first], data[Network::kComparators[I].second]), ...);
+}
+
+// Sort data[0, N)
+template <std::size_t N, typename T>
+constexpr void sortNetwork(T *data)
+{
+  applyNetwork<SortNetwork<N>>(data, std::make_index_sequence<SortNetwork<N>::kSize>());
+}
+
+template <typename T, std::size_t N>
+constexpr void sortNetwork(std::array<T, N> &values)
+{
+  sortNetwork<N>(values.data());
+}
+
+// Place the lower median of data[0, N) at data[(N - 1) / 2] and return it; the other elements are only permuted
+template <std::size_t N, typename T>
+constexpr T medianNetwork(T *data)
+{
+  applyNetwork<MedianNetwork<N>>(data, std::make_index_sequence<MedianNetwork<N>::kSize>());
+  return data[(N - 1) / 2];
+}
+
+template <typename T, std::size_t N>
+constexpr T medianNetwork(std::array<T, N> values)
+{
+  return medianNetwork<N>(values.data());
+}
+
+template <typename T, std::size_t... I>
+void sortNetwork(T *data, std::size_t n, std::index_sequence<I...>)
+{
+  static void (*const kNetworks[])(T *) = {&sortNetwork<I, T>...};
+  kNetworks[n](data);
+}
+
+// Sort data[0, n) for a size known only at run time, n <= kSortNetworkMaxSize
+template <typename T>
+void sortNetwork(T *data, std::size_t n)
+{
+  sortNetwork(data, n, std::make_index_sequence<kSortNetworkMaxSize + 1>());
+}
+
+// Sort [first, last) by less: a sorting network for short contiguous ranges of arithmetic keys under plain operator<,
+// insertion sort otherwise. Used as the small-subarray cutoff of other sorts.
+template <typename RandomIt, typename Less>
+void smallSort(RandomIt first, RandomIt last, Less &less)
+{
+  using T = typename std::iterator_traits<RandomIt>::value_type;
+  if constexpr (std::is_arithmetic<T>::value && std::is_same<Less, PlainLess>::value &&
+                IsContiguousIterator<RandomIt>::value)
+  {
+    if (last - first <= static_cast<std::ptrdiff_t>(kSortNetworkMaxSize))
+    {
+      sortNetwork(&*first, static_cast<std::size_t>(last - first));
+      return;
+    }
+  }
+  insertSort(first, last, std::ref(less));
+}
+
+// Sort the closed range [low, high]
+template <typename T>
+void smallSort(std::vector<T> &arr, std::size_t low, std::size_t high)
+{
+  if (high <= low) { return; }
+  PlainLess less;
+  smallSort(arr.begin() + low, arr.begin() + high + 1, less);
+}
+
+#endif // SORTING_SORT_NETWORK_H
@@ -0,0 +1,2 @@
+
+#include "sorting/sort_view/sort_view.h"
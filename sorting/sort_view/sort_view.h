@@ -0,0 +1,189 @@
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifndef SORTING_SORT_VIEW_H
+#define SORTING_SORT_VIEW_H
+
+/*
+Views and comparator adaptors for the iterator overloads of the sorting routines, so that memory the caller owns
+(memory-mapped files, Eigen matrices, ring buffers) is sorted where it is, without copying it into a std::vector.
+
+- `Span<T>`: a pointer and a length, the C++17 stand-in for std::span.
+- `StridedSpan<T>`: every stride-th element, e.g. a column of a row-major Eigen matrix or one field of an array of
+  records; its iterator is random access, so it sorts in place like any other range.
+- Every iterator overload takes a comparator (`std::less<>` by default) and a projection (`SortIdentity` by default)
+  and orders elements by comp(proj(a), proj(b)). A projection is any callable, or a pointer to member such as
+  &Record::time.
+*/
+
+// Projection that returns its argument unchanged
+struct SortIdentity
+{
+  template <typename U>
+  constexpr U &&operator()(U &&value) const noexcept
+  {
+    return std::forward<U>(value);
+  }
+};
+
+// comp(proj(a), proj(b)): the ordering that the iterator overloads sort by
+template <typename Compare, typename Projection>
+struct ProjectedCompare
+{
+  Compare comp;
+  Projection proj;
+
+  template <typename A, typename B>
+  bool operator()(A &&a, B &&b) const
+  {
+    return comp(std::invoke(proj, std::forward<A>(a)), std::invoke(proj, std::forward<B>(b)));
+  }
+};
+
+template <typename Compare, typename Projection>
+ProjectedCompare<Compare, Projection> projectedCompare(Compare comp, Projection proj)
+{
+  return {std::move(comp), std::move(proj)};
+}
+
+// The ordering of the std::vector overloads: plain operator<, so kernels written for arithmetic keys (sorting
+// networks, vectorized partitions) may stand in for it
+using PlainLess = ProjectedCompare<std::less<>, SortIdentity>;
+
+// Pointers and std::vector iterators: the elements are contiguous and the kernels may read them through &*it
+template <typename RandomIt, typename Value = typename std::iterator_traits<RandomIt>::value_type>
+struct IsContiguousIterator
+    : std::integral_constant<bool, std::is_pointer<RandomIt>::value ||
+                                       (!std::is_same<Value, bool>::value &&
+                                        std::is_same<RandomIt, typename std::vector<Value>::iterator>::value)>
+{
+};
+
+// Contiguous view of size elements starting at data
+template <typename T>
+class Span
+{
+ public:
+  using value_type = std::remove_cv_t<T>;
+  using iterator   = T *;
+
+  Span() = default;
+  Span(T *data, std::size_t size) : data_(data), size_(size) {}
+  Span(T *first, T *last) : data_(first), size_(static_cast<std::size_t>(last - first)) {}
+  template <typename U, typename = std::enable_if_t<std::is_convertible<U *, T *>::value>>
+  Span(std::vector<U> &values) : data_(values.data()), size_(values.size()) {}
+
+  T *data() const { return data_; }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  T &operator[](std::size_t i) const { return data_[i]; }
+  iterator begin() const { return data_; }
+  iterator end() const { return data_ + size_; }
+
+  Span subspan(std::size_t offset, std::size_t count) const { return Span(data_ + offset, count); }
+
+ private:
+  T *data_          = nullptr;
+  std::size_t size_ = 0;
+};
+
+// Random-access iterator over every stride-th element; stride is in elements and may be negative
+template <typename T>
+class StridedIterator
+{
+ public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type        = std::remove_cv_t<T>;
+  using difference_type   = std::ptrdiff_t;
+  using pointer           = T *;
+  using reference         = T &;
+
+  StridedIterator() = default;
+  StridedIterator(T *position, std::ptrdiff_t stride) : position_(position), stride_(stride) {}
+
+  reference operator*() const { return *position_; }
+  pointer operator->() const { return position_; }
+  reference operator[](difference_type i) const { return position_[i * stride_]; }
+
+  StridedIterator &operator++()
+  {
+    position_ += stride_;
+    return *this;
+  }
+  StridedIterator operator++(int)
+  {
+    StridedIterator old = *this;
+    position_ += stride_;
+    return old;
+  }
+  StridedIterator &operator--()
+  {
+    position_ -= stride_;
+    return *this;
+  }
+  StridedIterator operator--(int)
+  {
+    StridedIterator old = *this;
+    position_ -= stride_;
+    return old;
+  }
+  StridedIterator &operator+=(difference_type n)
+  {
+    position_ += n * stride_;
+    return *this;
+  }
+  StridedIterator &operator-=(difference_type n)
+  {
+    position_ -= n * stride_;
+    return *this;
+  }
+  friend StridedIterator operator+(StridedIterator it, difference_type n) { return it += n; }
+  friend StridedIterator operator+(difference_type n, StridedIterator it) { return it += n; }
+  friend StridedIterator operator-(StridedIterator it, difference_type n) { return it -= n; }
+  friend difference_type operator-(const StridedIterator &a, const StridedIterator &b)
+  {
+    return (a.position_ - b.position_) / a.stride_;
+  }
+
+  friend bool operator==(const StridedIterator &a, const StridedIterator &b) { return a.position_ == b.position_; }
+  friend bool operator!=(const StridedIterator &a, const StridedIterator &b) { return a.position_ != b.position_; }
+  friend bool operator<(const StridedIterator &a, const StridedIterator &b) { return (b - a) > 0; }
+  friend bool operator>(const StridedIterator &a, const StridedIterator &b) { return b < a; }
+  friend bool operator<=(const StridedIterator &a, const StridedIterator &b) { return !(b < a); }
+  friend bool operator>=(const StridedIterator &a, const StridedIterator &b) { return !(a < b); }
+
+ private:
+  T *position_           = nullptr;
+  std::ptrdiff_t stride_ = 1;
+};
+
+// View of size elements, stride elements apart, starting at data
+template <typename T>
+class StridedSpan
+{
+ public:
+  using value_type = std::remove_cv_t<T>;
+  using iterator   = StridedIterator<T>;
+
+  StridedSpan() = default;
+  StridedSpan(T *data, std::size_t size, std::ptrdiff_t stride) : data_(data), size_(size), stride_(stride) {}
+
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  std::ptrdiff_t stride() const { return stride_; }
+  T &operator[](std::size_t i) const { return data_[static_cast<std::ptrdiff_t>(i) * stride_]; }
+  iterator begin() const { return iterator(data_, stride_); }
+  iterator end() const { return iterator(data_ + static_cast<std::ptrdiff_t>(size_) * stride_, stride_); }
+
+ private:
+  T *data_               = nullptr;
+  std::size_t size_      = 0;
+  std::ptrdiff_t stride_ = 1;
+};
+
+#endif // SORTING_SORT_VIEW_H
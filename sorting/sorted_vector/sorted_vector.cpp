@@ -0,0 +1,2 @@
+
+#include "sorting/sorted_vector/sorted_vector.h"
@@ -0,0 +1,284 @@
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#ifndef SORTING_SORTED_VECTOR_H
+#define SORTING_SORTED_VECTOR_H
+
+/*
+Online sorted container (a sorted multiset with ranks) for streams of inserts and erases, where `insertSort` on one
+`std::vector` costs O(n) moves per insert.
+
+The keys live in a list of sorted chunks of at most kSortedVectorMaxChunk keys. A search binary-searches the chunk
+maxima, then the chunk. An insert or erase moves at most one chunk's worth of keys, and a Fenwick tree over the chunk
+sizes turns ranks into chunk positions. A full chunk splits in two, and a chunk that drops below a quarter of the
+maximum merges with its neighbour; the Fenwick tree is rebuilt only on these structural changes.
+
+|property|description|
+|---|---|
+|Insert / Erase|O(log n + kSortedVectorMaxChunk) moves of contiguous keys, plus O(n / kSortedVectorMaxChunk) amortized over a chunk's lifetime for splits.|
+|Rank / Select|O(log n).|
+|Iteration|in order over contiguous chunks, so a range scan streams through memory.|
+|Stability|equal keys are kept in insertion order.|
+*/
+
+// Largest chunk; a chunk that grows past it splits in two
+constexpr std::size_t kSortedVectorMaxChunk = 1024;
+
+template <typename T>
+class SortedVector
+{
+ public:
+  class const_iterator
+  {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type        = T;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = const T *;
+    using reference         = const T &;
+
+    const_iterator() = default;
+
+    reference operator*() const { return owner_->chunks_[chunk_][index_]; }
+    pointer operator->() const { return &**this; }
+
+    const_iterator &operator++()
+    {
+      if (++index_ == owner_->chunks_[chunk_].size())
+      {
+        ++chunk_;
+        index_ = 0;
+      }
+      return *this;
+    }
+    const_iterator operator++(int)
+    {
+      const_iterator old = *this;
+      ++*this;
+      return old;
+    }
+    const_iterator &operator--()
+    {
+      if (index_ == 0) { index_ = owner_->chunks_[--chunk_].size(); }
+      --index_;
+      return *this;
+    }
+    const_iterator operator--(int)
+    {
+      const_iterator old = *this;
+      --*this;
+      return old;
+    }
+
+    bool operator==(const const_iterator &other) const { return chunk_ == other.chunk_ && index_ == other.index_; }
+    bool operator!=(const const_iterator &other) const { return !(*this == other); }
+
+   private:
+    friend class SortedVector;
+    const_iterator(const SortedVector *owner, std::size_t chunk, std::size_t index) :
+      owner_(owner), chunk_(chunk), index_(index) {}
+
+    const SortedVector *owner_ = nullptr;
+    std::size_t chunk_ = 0, index_ = 0;
+  };
+
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  void clear()
+  {
+    chunks_.clear();
+    maxima_.clear();
+    fenwick_.clear();
+    size_ = 0;
+  }
+
+  // Insert after any equal keys
+  void insert(const T &value)
+  {
+    ++size_;
+    if (chunks_.empty())
+    {
+      chunks_.push_back({value});
+      maxima_.push_back(value);
+      rebuild();
+      return;
+    }
+
+    std::size_t c         = std::upper_bound(maxima_.begin(), maxima_.end(), value) - maxima_.begin();
+    c                     = std::min(c, chunks_.size() - 1);
+    std::vector<T> &chunk = chunks_[c];
+    chunk.insert(std::upper_bound(chunk.begin(), chunk.end(), value), value);
+    maxima_[c] = chunk.back();
+
+    if (chunk.size() > kSortedVectorMaxChunk) { split(c); }
+    else { add(c, 1); }
+  }
+
+  // Erase one key equal to value; returns whether there was one
+  bool erase(const T &value)
+  {
+    std::size_t c = std::lower_bound(maxima_.begin(), maxima_.end(), value) - maxima_.begin();
+    if (c == chunks_.size()) { return false; }
+    auto it = std::lower_bound(chunks_[c].begin(), chunks_[c].end(), value);
+    if (value < *it) { return false; }
+    eraseAt(c, static_cast<std::size_t>(it - chunks_[c].begin()));
+    return true;
+  }
+
+  // Erase the key of the given rank
+  void eraseRank(std::size_t rank)
+  {
+    std::pair<std::size_t, std::size_t> position = locate(rank);
+    eraseAt(position.first, position.second);
+  }
+
+  // The key of the given rank, 0 <= rank < size()
+  const T &select(std::size_t rank) const
+  {
+    std::pair<std::size_t, std::size_t> position = locate(rank);
+    return chunks_[position.first][position.second];
+  }
+  const T &operator[](std::size_t rank) const { return select(rank); }
+
+  // Number of keys less than value
+  std::size_t rank(const T &value) const
+  {
+    std::size_t c = std::lower_bound(maxima_.begin(), maxima_.end(), value) - maxima_.begin();
+    if (c == chunks_.size()) { return size_; }
+    return prefix(c) + (std::lower_bound(chunks_[c].begin(), chunks_[c].end(), value) - chunks_[c].begin());
+  }
+
+  std::size_t count(const T &value) const { return upperRank(value) - rank(value); }
+
+  const_iterator begin() const { return const_iterator(this, 0, 0); }
+  const_iterator end() const { return const_iterator(this, chunks_.size(), 0); }
+
+  // First key not less than value
+  const_iterator lowerBound(const T &value) const
+  {
+    std::size_t c = std::lower_bound(maxima_.begin(), maxima_.end(), value) - maxima_.begin();
+    if (c == chunks_.size()) { return end(); }
+    return const_iterator(this, c, std::lower_bound(chunks_[c].begin(), chunks_[c].end(), value) - chunks_[c].begin());
+  }
+
+  // First key greater than value
+  const_iterator upperBound(const T &value) const
+  {
+    std::size_t c = std::upper_bound(maxima_.begin(), maxima_.end(), value) - maxima_.begin();
+    if (c == chunks_.size()) { return end(); }
+    return const_iterator(this, c, std::upper_bound(chunks_[c].begin(), chunks_[c].end(), value) - chunks_[c].begin());
+  }
+
+ private:
+  std::size_t upperRank(const T &value) const
+  {
+    std::size_t c = std::upper_bound(maxima_.begin(), maxima_.end(), value) - maxima_.begin();
+    if (c == chunks_.size()) { return size_; }
+    return prefix(c) + (std::upper_bound(chunks_[c].begin(), chunks_[c].end(), value) - chunks_[c].begin());
+  }
+
+  void eraseAt(std::size_t c, std::size_t index)
+  {
+    --size_;
+    std::vector<T> &chunk = chunks_[c];
+    chunk.erase(chunk.begin() + index);
+    if (chunk.empty())
+    {
+      chunks_.erase(chunks_.begin() + c);
+      maxima_.erase(maxima_.begin() + c);
+      rebuild();
+      return;
+    }
+    maxima_[c] = chunk.back();
+
+    if (chunk.size() < kSortedVectorMaxChunk / 4 && chunks_.size() > 1)
+    {
+      // Merge with the next chunk (or the previous one for the last chunk), then split again if that overfills
+      std::size_t left       = c + 1 < chunks_.size() ? c : c - 1;
+      std::vector<T> &merged = chunks_[left];
+      merged.insert(merged.end(), std::make_move_iterator(chunks_[left + 1].begin()),
+                    std::make_move_iterator(chunks_[left + 1].end()));
+      maxima_[left] = merged.back();
+      chunks_.erase(chunks_.begin() + left + 1);
+      maxima_.erase(maxima_.begin() + left + 1);
+      if (merged.size() > kSortedVectorMaxChunk) { split(left); }
+      else { rebuild(); }
+      return;
+    }
+    add(c, -1);
+  }
+
+  void split(std::size_t c)
+  {
+    std::vector<T> &chunk = chunks_[c];
+    auto middle           = chunk.begin() + chunk.size() / 2;
+    std::vector<T> upper(std::make_move_iterator(middle), std::make_move_iterator(chunk.end()));
+    chunk.erase(middle, chunk.end());
+    maxima_[c] = chunk.back();
+    maxima_.insert(maxima_.begin() + c + 1, upper.back());
+    chunks_.insert(chunks_.begin() + c + 1, std::move(upper));
+    rebuild();
+  }
+
+  // Fenwick tree over the chunk sizes, 1-based
+  void rebuild()
+  {
+    fenwick_.assign(chunks_.size() + 1, 0);
+    for (std::size_t i = 1; i <= chunks_.size(); ++i)
+    {
+      fenwick_[i] += chunks_[i - 1].size();
+      std::size_t parent = i + (i & (~i + 1));
+      if (parent <= chunks_.size()) { fenwick_[parent] += fenwick_[i]; }
+    }
+  }
+
+  void add(std::size_t c, int delta)
+  {
+    for (std::size_t i = c + 1; i < fenwick_.size(); i += i & (~i + 1))
+    {
+      fenwick_[i] += delta;
+    }
+  }
+
+  // Keys in the chunks before chunk c
+  std::size_t prefix(std::size_t c) const
+  {
+    std::size_t sum = 0;
+    for (std::size_t i = c; i > 0; i -= i & (~i + 1))
+    {
+      sum += fenwick_[i];
+    }
+    return sum;
+  }
+
+  // (chunk, index) of the key of the given rank, by descending the Fenwick tree
+  std::pair<std::size_t, std::size_t> locate(std::size_t rank) const
+  {
+    std::size_t c = 0, step = 1;
+    while (step * 2 < fenwick_.size())
+    {
+      step *= 2;
+    }
+    for (; step > 0; step /= 2)
+    {
+      if (c + step < fenwick_.size() && fenwick_[c + step] <= rank)
+      {
+        c += step;
+        rank -= fenwick_[c];
+      }
+    }
+    return {c, rank};
+  }
+
+  std::vector<std::vector<T>> chunks_;
+  std::vector<T> maxima_; // the last key of every chunk
+  std::vector<std::size_t> fenwick_;
+  std::size_t size_ = 0;
+};
+
+#endif // SORTING_SORTED_VECTOR_H
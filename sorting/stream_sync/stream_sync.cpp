@@ -0,0 +1,2 @@
+
+#include "sorting/stream_sync/stream_sync.h"
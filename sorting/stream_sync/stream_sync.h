@@ -0,0 +1,156 @@
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#ifndef SORTING_STREAM_SYNC_H
+#define SORTING_STREAM_SYNC_H
+
+/*
+Streaming counterpart of `findPairsOptimized` for N live sensor streams (lidar, camera, IMU, GNSS, ...).
+
+Stream 0 is the reference. Every reference sample is matched with the nearest sample of each other stream, and the
+tuple is emitted once no later sample can come closer, i.e. once every other stream has delivered a sample at or
+after the reference time. A tuple is emitted only if all of its matches are within `thr`, the same rule as
+`findPairsOptimized`; ties go to the earlier sample. Tuples leave in reference order, so nothing needs sorting.
+
+Each stream keeps a ring buffer of fixed capacity. A sample is dropped once a later sample of the same stream is at
+or before the oldest reference time still needed, because that later sample is at least as close.
+
+|property|description|
+|---|---|
+|Time Complexity|O(N) per sample amortized: every sample enters and leaves its ring once, and a tuple costs O(N).|
+|Space Complexity|O(N * capacity), fixed at construction.|
+|Order|timestamps must not decrease within a stream; the streams may interleave in any order.|
+|Overflow|a full stream ring drops its oldest sample; a full reference ring resolves its oldest sample with the samples at hand.|
+*/
+
+template <typename T, std::size_t N>
+class StreamSynchronizer
+{
+ public:
+  static_assert(N >= 2, "a synchronizer needs the reference stream and at least one more");
+  using Tuple = std::array<T, N>;
+
+  // capacity is rounded up to a power of two
+  explicit StreamSynchronizer(T thr, std::size_t capacity = 1024) : thr_(thr)
+  {
+    std::size_t rounded = 2;
+    while (rounded < capacity)
+    {
+      rounded *= 2;
+    }
+    for (auto &ring : rings_)
+    {
+      ring.samples.resize(rounded);
+    }
+  }
+
+  // Add a sample of a stream; emit(const Tuple &) receives every tuple this completes
+  template <typename Emit>
+  void push(std::size_t stream, const T &timestamp, Emit &&emit)
+  {
+    Ring &ring = rings_[stream];
+    if (ring.size == ring.samples.size())
+    {
+      if (stream == 0) { resolve(emit); }
+      else { ring.pop(); }
+    }
+    ring.push(timestamp);
+
+    while (rings_[0].size > 0 && ready())
+    {
+      resolve(emit);
+    }
+  }
+
+  // End of input: resolve the remaining reference samples with the samples at hand
+  template <typename Emit>
+  void flush(Emit &&emit)
+  {
+    while (rings_[0].size > 0)
+    {
+      resolve(emit);
+    }
+  }
+
+  std::size_t emitted() const { return emitted_; }
+
+ private:
+  struct Ring
+  {
+    std::vector<T> samples;
+    std::size_t head = 0, size = 0;
+
+    const T &operator[](std::size_t i) const { return samples[(head + i) & (samples.size() - 1)]; }
+    const T &back() const { return (*this)[size - 1]; }
+    void push(const T &value)
+    {
+      samples[(head + size) & (samples.size() - 1)] = value;
+      ++size;
+    }
+    void pop()
+    {
+      head = (head + 1) & (samples.size() - 1);
+      --size;
+    }
+  };
+
+  // Whether every other stream has reached the oldest reference time, so no match can still improve
+  bool ready() const
+  {
+    const T &reference = rings_[0][0];
+    for (std::size_t j = 1; j < N; ++j)
+    {
+      if (rings_[j].size == 0 || rings_[j].back() < reference) { return false; }
+    }
+    return true;
+  }
+
+  // Match the oldest reference sample with what the other streams hold now, then drop it
+  template <typename Emit>
+  void resolve(Emit &emit)
+  {
+    Tuple tuple;
+    tuple[0]     = rings_[0][0];
+    bool matched = true;
+    for (std::size_t j = 1; j < N; ++j)
+    {
+      Ring &ring = rings_[j];
+      // Later reference samples are not earlier, so samples superseded at this time are never needed again
+      while (ring.size >= 2 && !(tuple[0] < ring[1]))
+      {
+        ring.pop();
+      }
+      if (ring.size == 0)
+      {
+        matched = false;
+        continue;
+      }
+
+      // Candidates: the last sample at or before the reference time and the first one after it
+      T best = ring[0];
+      T diff = best < tuple[0] ? tuple[0] - best : best - tuple[0];
+      if (best < tuple[0] && ring.size >= 2 && ring[1] - tuple[0] < diff)
+      {
+        best = ring[1];
+        diff = ring[1] - tuple[0];
+      }
+      tuple[j] = best;
+      matched  = matched && !(thr_ < diff);
+    }
+    rings_[0].pop();
+
+    if (matched)
+    {
+      ++emitted_;
+      emit(static_cast<const Tuple &>(tuple));
+    }
+  }
+
+  T thr_;
+  std::array<Ring, N> rings_;
+  std::size_t emitted_ = 0;
+};
+
+#endif // SORTING_STREAM_SYNC_H
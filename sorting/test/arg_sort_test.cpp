@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <string>
+
+#include "sorting/arg_sort/arg_sort.h"
+#include "sorting/parallel_sort/parallel_sort.h"
+#include "sorting/power_sort/power_sort.h"
+
+// The pattern argSort replaces: an index vector sorted by a lambda that looks the keys up
+template <typename T>
+std::vector<std::size_t> iotaArgSort(const std::vector<T> &keys)
+{
+  std::vector<std::size_t> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return keys[a] < keys[b]; });
+  return order;
+}
+
+TEST(arg_sort_test, matches_stable_index_sort)
+{
+  std::mt19937 gen(1);
+  for (std::size_t n : {0, 1, 2, 17, 1000, 100000})
+  {
+    std::vector<int> keys(n);
+    for (auto &key : keys)
+    {
+      key = static_cast<int>(gen() % 100) - 50; // many duplicates
+    }
+    EXPECT_EQ(argSort(keys), iotaArgSort(keys));
+
+    std::vector<double> reals(n);
+    for (auto &real : reals)
+    {
+      real = std::uniform_real_distribution<double>(-1.0, 1.0)(gen);
+    }
+    EXPECT_EQ(argSort(reals), iotaArgSort(reals));
+  }
+}
+
+TEST(arg_sort_test, pluggable_sorts)
+{
+  std::mt19937 gen(2);
+  std::vector<float> keys(50000);
+  for (auto &key : keys)
+  {
+    key = static_cast<float>(gen() % 1000);
+  }
+  const std::vector<std::size_t> expected = iotaArgSort(keys);
+  EXPECT_EQ(argSort(keys, [](auto &pairs) { introSort(pairs); }), expected);
+  EXPECT_EQ(argSort(keys, [](auto &pairs) { powerSort(pairs); }), expected);
+  EXPECT_EQ(argSort(keys, [](auto &pairs) { parallelSort(pairs, 2); }), expected);
+  EXPECT_EQ(argSort(keys, [](auto &pairs) { std::sort(pairs.begin(), pairs.end()); }), expected);
+}
+
+TEST(arg_sort_test, signed_zeros_are_equal_keys)
+{
+  // -0.0 == +0.0, so every sort keeps them in input order
+  std::vector<double> keys = {0.0, -0.0, 1.0, 0.0, -0.0};
+  const std::vector<std::size_t> expected = {0, 1, 3, 4, 2};
+  EXPECT_EQ(iotaArgSort(keys), expected);
+  EXPECT_EQ(argSort(keys), expected);
+  EXPECT_EQ(argSort(keys, [](auto &pairs) { introSort(pairs); }), expected);
+  std::vector<float> floats(keys.begin(), keys.end());
+  EXPECT_EQ(argSort(floats), expected);
+
+  // The keys themselves keep their sign
+  std::vector<int> payload = {0, 1, 2, 3, 4};
+  coSort(keys, payload);
+  EXPECT_EQ(payload, (std::vector<int>{0, 1, 3, 4, 2}));
+  EXPECT_TRUE(std::signbit(keys[1]) && !std::signbit(keys[2]) && std::signbit(keys[3]));
+}
+
+TEST(arg_sort_test, non_arithmetic_keys)
+{
+  std::vector<std::string> keys = {"pear", "apple", "fig", "apple", "kiwi", "fig"};
+  EXPECT_EQ(argSort(keys), iotaArgSort(keys));
+}
+
+TEST(arg_sort_test, co_sort_payloads)
+{
+  std::mt19937 gen(3);
+  const std::size_t n = 20000;
+  std::vector<double> keys(n);
+  std::vector<std::size_t> ids(n);
+  std::vector<std::string> names(n);
+  std::vector<bool> flags(n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    keys[i]  = static_cast<double>(gen() % 500);
+    ids[i]   = i;
+    names[i] = "p" + std::to_string(i);
+    flags[i] = i % 3 == 0;
+  }
+  const std::vector<double> original = keys;
+  const std::vector<std::size_t> order = iotaArgSort(keys);
+
+  coSort(keys, ids, names, flags);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    ASSERT_EQ(keys[i], original[order[i]]);
+    ASSERT_EQ(ids[i], order[i]);
+    ASSERT_EQ(names[i], "p" + std::to_string(order[i]));
+    ASSERT_EQ(flags[i], order[i] % 3 == 0);
+  }
+
+  std::vector<std::string> words = {"b", "a", "c"};
+  std::vector<int> ranks         = {2, 1, 3};
+  coSortWith([](auto &pairs) { powerSort(pairs); }, words, ranks);
+  EXPECT_EQ(words, (std::vector<std::string>{"a", "b", "c"}));
+  EXPECT_EQ(ranks, (std::vector<int>{1, 2, 3}));
+
+  std::vector<int> short_payload(n - 1);
+  EXPECT_THROW(coSort(keys, short_payload), std::invalid_argument);
+}
+
+TEST(arg_sort_test, apply_permutation)
+{
+  std::vector<int> keys            = {30, 10, 20};
+  std::vector<std::string> payload = {"c", "a", "b"};
+  applyPermutation(payload, argSort(keys));
+  EXPECT_EQ(payload, (std::vector<std::string>{"a", "b", "c"}));
+  EXPECT_THROW(applyPermutation(payload, std::vector<std::size_t>(2)), std::invalid_argument);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <functional>
 #include <iostream>
+#include <random>
 
 #include "sorting/bfprt/bfprt.h"
 
@@ -10,6 +13,198 @@ TEST(bfprt_test, test1)
   std::size_t k        = 5; // Find the k-th smallest element, k is zero-based index
   std::size_t result   = select(arr, 0, arr.size() - 1, k);
   std::cout << "The " << k + 1 << "th smallest element is " << result << std::endl;
+  EXPECT_EQ(result, 5u);
+}
+
+TEST(bfprt_test, select_large_values)
+{
+  // The pivot must be tracked by index, not by value
+  std::mt19937 gen(1);
+  std::vector<double> arr(1000);
+  for (auto &value : arr)
+  {
+    value = std::uniform_real_distribution<double>(1e6, 2e6)(gen);
+  }
+  std::vector<double> sorted = arr;
+  std::sort(sorted.begin(), sorted.end());
+  for (std::size_t k : {0, 1, 499, 500, 998, 999})
+  {
+    std::vector<double> a = arr;
+    EXPECT_EQ(select(a, 0, a.size() - 1, k), sorted[k]);
+  }
+}
+
+TEST(bfprt_test, select_duplicate_keys)
+{
+  // Keys equal to the pivot are split off, so few distinct keys do not make BFPRT quadratic
+  std::mt19937 gen(3);
+  std::vector<int> arr(200000);
+  for (auto &value : arr)
+  {
+    value = static_cast<int>(gen() % 3);
+  }
+  std::vector<int> sorted = arr;
+  std::sort(sorted.begin(), sorted.end());
+  for (std::size_t k : {std::size_t(0), arr.size() / 2, arr.size() - 1})
+  {
+    std::vector<int> a = arr;
+    EXPECT_EQ(select(a, 0, a.size() - 1, k), sorted[k]);
+  }
+}
+
+TEST(bfprt_test, nth_element)
+{
+  std::mt19937 gen(2);
+  for (std::size_t n : {1, 2, 15, 16, 17, 100, 10000})
+  {
+    std::vector<std::vector<int>> inputs(4, std::vector<int>(n));
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      inputs[0][i] = static_cast<int>(gen());
+      inputs[1][i] = static_cast<int>(i);
+      inputs[2][i] = static_cast<int>(gen() % 3);
+      inputs[3][i] = static_cast<int>(i % 2 == 0 ? i : n - i); // interleaved, hostile to median-of-three
+    }
+    for (const auto &input : inputs)
+    {
+      std::vector<int> sorted = input;
+      std::sort(sorted.begin(), sorted.end());
+      for (std::size_t k : {std::size_t(0), n / 2, n - 1})
+      {
+        std::vector<int> a = input;
+        nthElement(a, k);
+        ASSERT_EQ(a[k], sorted[k]);
+        ASSERT_TRUE(std::all_of(a.begin(), a.begin() + k, [&](int x) { return x <= a[k]; }));
+        ASSERT_TRUE(std::all_of(a.begin() + k, a.end(), [&](int x) { return x >= a[k]; }));
+
+        a = input;
+        ASSERT_EQ(introSelect(a, 0, n - 1, k), sorted[k]);
+      }
+    }
+  }
+}
+
+TEST(bfprt_test, nth_element_generic_keys)
+{
+  // unsigned keys take the scalar three-way partition path
+  std::mt19937 gen(5);
+  std::vector<unsigned> input(5000);
+  for (auto &value : input)
+  {
+    value = gen() % 50;
+  }
+  std::vector<unsigned> sorted = input;
+  std::sort(sorted.begin(), sorted.end());
+  for (std::size_t k : {0, 1234, 2500, 4999})
+  {
+    std::vector<unsigned> a = input;
+    EXPECT_EQ(introSelect(a, 0, a.size() - 1, k), sorted[k]);
+  }
+}
+
+// McIlroy's adversary ("A Killer Adversary for Quicksort") behind operator<: values are frozen only when compared,
+// always so that the current pivot candidate ends up as small as possible
+struct AdversaryKey
+{
+  std::size_t id;
+
+  static std::vector<std::size_t> value;
+  static std::size_t gas, solid, candidate, comparisons;
+
+  static void reset(std::size_t n)
+  {
+    value.assign(n, n);
+    gas         = n;
+    solid       = 0;
+    candidate   = 0;
+    comparisons = 0;
+  }
+
+  friend bool operator<(const AdversaryKey &a, const AdversaryKey &b)
+  {
+    ++comparisons;
+    std::size_t x = a.id, y = b.id;
+    if (value[x] == gas && value[y] == gas) { value[x == candidate ? x : y] = solid++; }
+    if (value[x] == gas) { candidate = x; }
+    else if (value[y] == gas) { candidate = y; }
+    return value[x] < value[y];
+  }
+};
+std::vector<std::size_t> AdversaryKey::value;
+std::size_t AdversaryKey::gas, AdversaryKey::solid, AdversaryKey::candidate, AdversaryKey::comparisons;
+
+TEST(bfprt_test, nth_element_is_linear)
+{
+  // Against the adversary every sampled pivot is bad; the median-of-medians fallback keeps selection linear
+  for (std::size_t n : {10000, 100000, 1000000})
+  {
+    std::vector<AdversaryKey> keys(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      keys[i].id = i;
+    }
+    std::vector<AdversaryKey> a = keys;
+    AdversaryKey::reset(n);
+    nthElement(a, n / 2);
+    EXPECT_LT(AdversaryKey::comparisons, 25 * n) << n;
+
+    a = keys;
+    AdversaryKey::reset(n);
+    multiSelect(a, {n / 2, n * 99 / 100});
+    EXPECT_LT(AdversaryKey::comparisons, 30 * n) << n;
+  }
+}
+
+TEST(bfprt_test, partial_sort_and_top_k)
+{
+  std::vector<int> arr = {9, 1, 0, 5, 4, 8, 2, 6, 3, 7};
+
+  std::vector<int> a = arr;
+  partialSort(a, 4);
+  EXPECT_EQ(std::vector<int>(a.begin(), a.begin() + 4), std::vector<int>({0, 1, 2, 3}));
+
+  a = arr;
+  EXPECT_EQ(topK(a, 3), std::vector<int>({9, 8, 7}));
+  a = arr;
+  EXPECT_EQ(topK(a, 20).size(), arr.size());
+  EXPECT_TRUE(topK(a, 0).empty());
+}
+
+TEST(bfprt_test, multi_select)
+{
+  std::mt19937 gen(6);
+  for (std::size_t n : {1, 10, 17, 1000, 100000})
+  {
+    for (int distinct : {3, 1 << 30})
+    {
+      std::vector<int> input(n);
+      for (auto &value : input)
+      {
+        value = static_cast<int>(gen() % distinct);
+      }
+      std::vector<int> sorted = input;
+      std::sort(sorted.begin(), sorted.end());
+
+      std::vector<std::size_t> ranks = {n / 2, n * 9 / 10, n * 95 / 100, n * 99 / 100, n * 999 / 1000, 0, n - 1};
+      std::vector<int> a             = input;
+      std::vector<int> values        = multiSelect(a, ranks);
+      ASSERT_EQ(values.size(), ranks.size());
+      for (std::size_t i = 0; i < ranks.size(); ++i)
+      {
+        ASSERT_EQ(values[i], sorted[ranks[i]]);
+        ASSERT_EQ(a[ranks[i]], sorted[ranks[i]]);
+      }
+    }
+  }
+
+  std::vector<unsigned> generic = {5, 3, 9, 1, 7, 2, 8, 6, 4, 0, 15, 13, 19, 11, 17, 12, 18, 16, 14, 10};
+  EXPECT_EQ(multiSelect(generic, {2, 10, 19}), std::vector<unsigned>({2, 10, 19}));
+
+  // A rank past the end would shift every later result out of its slot: it throws and leaves the array alone
+  std::vector<unsigned> before = generic;
+  EXPECT_THROW(multiSelect(generic, {1, 20, 3}), std::out_of_range);
+  EXPECT_EQ(generic, before);
+  EXPECT_TRUE(multiSelect(generic, {}).empty());
 }
 
 int main(int argc, char **argv)
@@ -0,0 +1,110 @@
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include "sorting/external_sort/external_sort.h"
+
+std::string testPath(const std::string &name)
+{
+  return (std::filesystem::temp_directory_path() / ("external_sort_test_" + name)).string();
+}
+
+template <typename T>
+std::vector<T> readRecords(const std::string &path)
+{
+  std::ifstream file(path, std::ios::binary);
+  std::vector<T> records(std::filesystem::file_size(path) / sizeof(T));
+  file.read(reinterpret_cast<char *>(records.data()), records.size() * sizeof(T));
+  return records;
+}
+
+template <typename T>
+void checkExternalSort(const std::vector<T> &input, const ExternalSortOptions &options, std::size_t expected_runs)
+{
+  std::string in = testPath("in"), out = testPath("out");
+  writeRecords(in, input.data(), input.size());
+  EXPECT_EQ(externalSort<T>(in, out, options), expected_runs);
+
+  std::vector<T> expected = input;
+  std::sort(expected.begin(), expected.end());
+  EXPECT_EQ(readRecords<T>(out), expected);
+  std::filesystem::remove(in);
+  std::filesystem::remove(out);
+}
+
+std::size_t leftoverRuns()
+{
+  std::size_t count = 0;
+  for (const auto &entry : std::filesystem::directory_iterator(std::filesystem::temp_directory_path()))
+  {
+    count += entry.path().filename().string().rfind("bmath_sort_", 0) == 0;
+  }
+  return count;
+}
+
+TEST(external_sort_test, runs_and_passes)
+{
+  std::mt19937_64 gen(1);
+  std::vector<std::int64_t> input(100000);
+  for (auto &value : input)
+  {
+    value = static_cast<std::int64_t>(gen() % 1000);
+  }
+
+  ExternalSortOptions options;
+  checkExternalSort(input, options, 1); // fits in memory
+
+  options.memory_budget = 64 << 10; // 4096 records per run
+  checkExternalSort(input, options, 25);
+
+  options.max_fan_in = 3; // 25 -> 9 -> 3 -> 1 runs
+  checkExternalSort(input, options, 25);
+
+  checkExternalSort(std::vector<std::int64_t>(), options, 0);
+  EXPECT_EQ(leftoverRuns(), 0u);
+}
+
+TEST(external_sort_test, records)
+{
+  struct Record
+  {
+    std::uint32_t key;
+    float payload[3];
+    bool operator<(const Record &other) const { return key < other.key; }
+    bool operator==(const Record &other) const { return key == other.key; }
+  };
+
+  std::mt19937 gen(2);
+  std::vector<Record> input(30000);
+  for (auto &record : input)
+  {
+    record.key = gen();
+  }
+  ExternalSortOptions options;
+  options.memory_budget = 32 << 10;
+  options.max_fan_in    = 8;
+  checkExternalSort(input, options, (input.size() * sizeof(Record) + (16 << 10) - 1) / (16 << 10));
+}
+
+TEST(external_sort_test, errors)
+{
+  EXPECT_THROW(externalSort<int>(testPath("missing"), testPath("out")), std::runtime_error);
+
+  std::string in = testPath("odd");
+  char bytes[5] = {};
+  writeRecords(in, bytes, 5);
+  EXPECT_THROW(externalSort<int>(in, testPath("out")), std::runtime_error);
+  std::filesystem::remove(in);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,105 @@
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <random>
+
+#include "sorting/intro_sort/intro_sort.h"
+
+TEST(intro_sort_test, test1)
+{
+  std::vector<int> a = {10, 7, 8, 9, 1, 5};
+  introSort(a);
+  EXPECT_EQ(a, std::vector<int>({1, 5, 7, 8, 9, 10}));
+}
+
+TEST(intro_sort_test, sub_range)
+{
+  std::vector<int> a = {9, 8, 7, 6, 5, 4, 3, 2, 1, 0};
+  introSort(a, 2, 6);
+  EXPECT_EQ(a, std::vector<int>({9, 8, 3, 4, 5, 6, 7, 2, 1, 0}));
+}
+
+TEST(intro_sort_test, floating_point_keys)
+{
+  std::vector<double> a = {0.5, 0.25, 0.75, 0.125, 0.3, 0.2};
+  introSort(a);
+  EXPECT_TRUE(std::is_sorted(a.begin(), a.end()));
+  EXPECT_DOUBLE_EQ(a.front(), 0.125);
+  EXPECT_DOUBLE_EQ(a.back(), 0.75);
+}
+
+TEST(intro_sort_test, distributions)
+{
+  std::mt19937 gen(42);
+  for (std::size_t n : {0, 1, 2, 3, 17, 100, 1000, 10000})
+  {
+    std::vector<std::vector<int>> inputs(5, std::vector<int>(n));
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      inputs[0][i] = static_cast<int>(gen());
+      inputs[1][i] = static_cast<int>(i);
+      inputs[2][i] = static_cast<int>(n - i);
+      inputs[3][i] = static_cast<int>(gen() % 4);
+      inputs[4][i] = static_cast<int>(i < n / 2 ? i : n - i); // organ pipe
+    }
+    for (auto &input : inputs)
+    {
+      std::vector<int> expected = input;
+      std::sort(expected.begin(), expected.end());
+      introSort(input);
+      EXPECT_EQ(input, expected);
+    }
+  }
+}
+
+// McIlroy's adversary ("A Killer Adversary for Quicksort"): values are frozen only when compared, always so that the
+// current pivot candidate ends up as small as possible, which makes every partition as uneven as it can be
+struct QuicksortAdversary
+{
+  std::vector<std::size_t> value;
+  std::size_t gas, solid = 0, candidate = 0, comparisons = 0;
+
+  explicit QuicksortAdversary(std::size_t n) : value(n, n), gas(n) {}
+
+  bool operator()(std::size_t x, std::size_t y)
+  {
+    ++comparisons;
+    if (value[x] == gas && value[y] == gas) { value[x == candidate ? x : y] = solid++; }
+    if (value[x] == gas) { candidate = x; }
+    else if (value[y] == gas) { candidate = y; }
+    return value[x] < value[y];
+  }
+};
+
+TEST(intro_sort_test, heap_sort_fallback)
+{
+  std::vector<int> a = {5, 3, 9, 1, 7, 2, 8, 6, 4, 0};
+  heapSort(a, 1, 8);
+  EXPECT_EQ(a, std::vector<int>({5, 1, 2, 3, 4, 6, 7, 8, 9, 0}));
+
+  // Against the adversary the partitions stay uneven until the depth limit hands the ranges to heapsort
+  for (std::size_t n : {1000, 10000, 100000})
+  {
+    std::vector<std::size_t> items(n);
+    std::iota(items.begin(), items.end(), 0);
+    QuicksortAdversary adversary(n);
+    introSort(items.begin(), items.end(), std::ref(adversary));
+
+    const double n_log_n = static_cast<double>(n) * std::log2(static_cast<double>(n));
+    EXPECT_LT(static_cast<double>(adversary.comparisons), 8 * n_log_n) << n;
+    EXPECT_TRUE(std::is_sorted(items.begin(), items.end(), [&](std::size_t x, std::size_t y) {
+      return adversary.value[x] < adversary.value[y];
+    }));
+  }
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
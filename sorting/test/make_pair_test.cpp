@@ -3,6 +3,7 @@
 #include <gtest/gtest.h>
 
 #include <iostream>
+#include <random>
 
 #include <fstream>
 
@@ -52,6 +53,31 @@ TEST(bfprt_test, test1)
   }
 }
 
+TEST(make_pair_test, parallel_matches_sequential)
+{
+  std::mt19937_64 gen(1);
+  std::vector<double> a(400000), b(1000000);
+  for (auto &value : a)
+  {
+    value = std::uniform_real_distribution<double>(0.0, 1000.0)(gen);
+  }
+  for (auto &value : b)
+  {
+    value = std::round(std::uniform_real_distribution<double>(0.0, 1000.0)(gen) * 1000.0) / 1000.0; // duplicates
+  }
+  std::sort(a.begin(), a.end());
+  std::sort(b.begin(), b.end());
+
+  for (double thr : {0.0005, 0.01})
+  {
+    auto expected = findPairsOptimized(a, b, thr);
+    for (std::size_t threads : {1, 2, 3, 8, 64})
+    {
+      EXPECT_EQ(findPairsParallel(a, b, thr, threads), expected) << "threads " << threads;
+    }
+  }
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
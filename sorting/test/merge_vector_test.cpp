@@ -1,5 +1,12 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+
 #include "sorting/merge_vector/merge_vector.h"
 
 TEST(merge_vector_test, three_vectors)
@@ -37,6 +44,163 @@ TEST(merge_vector_test, several_vectors)
   std::cout << std::endl;
 }
 
+std::vector<std::vector<int>> randomSortedVectors(std::size_t k, std::size_t total, std::mt19937 &gen)
+{
+  std::vector<std::vector<int>> arrays(k);
+  for (std::size_t i = 0; i < total; ++i)
+  {
+    arrays[gen() % k].push_back(static_cast<int>(gen() % 100000));
+  }
+  for (auto &array : arrays)
+  {
+    std::sort(array.begin(), array.end());
+  }
+  return arrays;
+}
+
+TEST(merge_vector_test, loser_tree)
+{
+  std::mt19937 gen(1);
+  for (std::size_t k : {1, 2, 3, 5, 8, 13, 64, 100})
+  {
+    std::vector<std::vector<int>> arrays = randomSortedVectors(k, 5000, gen);
+    arrays[0].clear(); // empty inputs are skipped
+
+    std::vector<int> expected;
+    for (const auto &array : arrays)
+    {
+      expected.insert(expected.end(), array.begin(), array.end());
+    }
+    std::sort(expected.begin(), expected.end());
+
+    EXPECT_EQ(mergeSortedVectors(arrays), expected) << "k " << k;
+
+    std::vector<int> presized(expected.size());
+    int *end = mergeSortedVectors(arrays, presized.data());
+    EXPECT_EQ(end, presized.data() + presized.size());
+    EXPECT_EQ(presized, expected) << "k " << k;
+  }
+  EXPECT_TRUE(mergeSortedVectors(std::vector<std::vector<double>>()).empty());
+}
+
+TEST(merge_vector_test, stable_and_move_only)
+{
+  // Keys compare by the first member only, so the second records which input each element came from
+  struct Tagged
+  {
+    int key;
+    std::unique_ptr<std::string> source;
+    bool operator<(const Tagged &other) const { return key < other.key; }
+  };
+
+  std::vector<std::vector<Tagged>> arrays(3);
+  for (int i = 0; i < 10; ++i)
+  {
+    for (std::size_t s = 0; s < arrays.size(); ++s)
+    {
+      arrays[s].push_back({i / 2, std::make_unique<std::string>(std::to_string(s))});
+    }
+  }
+
+  std::vector<Tagged> merged = mergeSortedVectors(std::move(arrays));
+  ASSERT_EQ(merged.size(), 30u);
+  for (std::size_t i = 0; i < merged.size(); ++i)
+  {
+    EXPECT_EQ(merged[i].key, static_cast<int>(i / 6));
+    EXPECT_EQ(*merged[i].source, std::to_string(i % 6 / 2)); // equal keys leave in input order
+  }
+}
+
+TEST(merge_vector_test, merge_path_split)
+{
+  std::mt19937 gen(3);
+  std::vector<std::vector<int>> arrays = randomSortedVectors(7, 3000, gen);
+  for (auto &value : arrays[2])
+  {
+    value = 50000; // a run of ties across inputs
+  }
+  arrays[4].assign(arrays[4].size(), 50000);
+
+  using Iterator = std::vector<int>::const_iterator;
+  std::vector<std::pair<Iterator, Iterator>> ranges;
+  for (const auto &array : arrays)
+  {
+    ranges.emplace_back(array.begin(), array.end());
+  }
+
+  // The split at every rank must cut the stable merge of (value, input) pairs
+  std::vector<std::pair<int, std::size_t>> merged;
+  for (std::size_t j = 0; j < arrays.size(); ++j)
+  {
+    for (int value : arrays[j])
+    {
+      merged.emplace_back(value, j);
+    }
+  }
+  std::stable_sort(merged.begin(), merged.end());
+  for (std::size_t rank = 0; rank <= merged.size(); rank += 97)
+  {
+    std::vector<std::size_t> expected(arrays.size(), 0);
+    for (std::size_t i = 0; i < rank; ++i)
+    {
+      ++expected[merged[i].second];
+    }
+    ASSERT_EQ(mergePathSplit(ranges, rank), expected) << "rank " << rank;
+  }
+}
+
+TEST(merge_vector_test, parallel_merge)
+{
+  std::mt19937 gen(5);
+  for (std::size_t k : {1, 2, 3, 17, 300})
+  {
+    std::vector<std::vector<int>> arrays = randomSortedVectors(k, 300000, gen);
+    std::vector<int> expected            = mergeSortedVectors(arrays);
+    for (std::size_t threads : {1, 2, 3, 8})
+    {
+      EXPECT_EQ(parallelMergeSortedVectors(arrays, threads), expected) << "k " << k << ", threads " << threads;
+    }
+  }
+}
+
+template <std::size_t N>
+void checkMergeN(std::mt19937 &gen)
+{
+  std::array<std::vector<int>, N> arrays;
+  std::array<const std::vector<int> *, N> pointers;
+  std::vector<int> expected;
+  for (std::size_t i = 0; i < N; ++i)
+  {
+    arrays[i].resize(gen() % 4 == 0 ? 0 : gen() % 500);
+    for (auto &value : arrays[i])
+    {
+      value = gen() % 8 == 0 ? std::numeric_limits<int>::max() : static_cast<int>(gen() % 1000) - 500;
+    }
+    std::sort(arrays[i].begin(), arrays[i].end());
+    expected.insert(expected.end(), arrays[i].begin(), arrays[i].end());
+    pointers[i] = &arrays[i];
+  }
+  std::sort(expected.begin(), expected.end());
+  EXPECT_EQ(mergeSortedVectorsN<N>(pointers), expected) << "N " << N;
+}
+
+TEST(merge_vector_test, fixed_arity)
+{
+  std::mt19937 gen(4);
+  for (int repeat = 0; repeat < 20; ++repeat)
+  {
+    checkMergeN<1>(gen);
+    checkMergeN<2>(gen);
+    checkMergeN<3>(gen);
+    checkMergeN<5>(gen);
+    checkMergeN<8>(gen);
+  }
+
+  double inf = std::numeric_limits<double>::infinity();
+  std::vector<double> a = {-inf, 0.5, inf}, b = {}, c = {-1.0, inf, inf};
+  EXPECT_EQ(mergeSortedVectorsN(a, b, c), std::vector<double>({-inf, -1.0, 0.5, inf, inf, inf}));
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
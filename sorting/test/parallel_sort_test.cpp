@@ -0,0 +1,72 @@
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+#include "sorting/parallel_sort/parallel_sort.h"
+#include "sorting/quick_sort/quick_sort.h"
+
+TEST(parallel_sort_test, test1)
+{
+  std::vector<int> a = {10, 7, 8, 9, 1, 5};
+  parallelSort(a);
+  EXPECT_EQ(a, std::vector<int>({1, 5, 7, 8, 9, 10}));
+}
+
+TEST(parallel_sort_test, threads_and_cutoffs)
+{
+  std::mt19937 gen(1);
+  std::vector<double> random(100000), few_unique(100000);
+  for (std::size_t i = 0; i < random.size(); ++i)
+  {
+    random[i]     = std::uniform_real_distribution<double>(-1.0, 1.0)(gen);
+    few_unique[i] = static_cast<double>(gen() % 3);
+  }
+
+  for (const auto &input : {random, few_unique})
+  {
+    std::vector<double> expected = input;
+    std::sort(expected.begin(), expected.end());
+    for (std::size_t threads : {1, 2, 3, 8})
+    {
+      for (std::size_t cutoff : {0, 1000, 1000000})
+      {
+        std::vector<double> a = input;
+        parallelSort(a, threads, cutoff);
+        EXPECT_EQ(a, expected) << "threads " << threads << ", cutoff " << cutoff;
+      }
+    }
+  }
+}
+
+TEST(parallel_sort_test, duplicate_heavy_keys)
+{
+  // Few unique keys, one key holding 90% of the input, and a single key: heavy keys become equality buckets
+  std::mt19937 gen(2);
+  std::vector<int> few_unique(200000), heavy(200000), constant(200000, 42);
+  for (std::size_t i = 0; i < few_unique.size(); ++i)
+  {
+    few_unique[i] = static_cast<int>(gen() % 16);
+    heavy[i]      = gen() % 10 == 0 ? static_cast<int>(gen()) : 7;
+  }
+
+  for (const auto &input : {few_unique, heavy, constant})
+  {
+    std::vector<int> expected = input;
+    std::sort(expected.begin(), expected.end());
+    for (std::size_t threads : {2, 3, 8, 32})
+    {
+      std::vector<int> a = input;
+      parallelSort(a, threads, 1000);
+      EXPECT_EQ(a, expected) << "threads " << threads;
+    }
+  }
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
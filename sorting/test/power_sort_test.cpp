@@ -0,0 +1,91 @@
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "sorting/power_sort/power_sort.h"
+
+// Keys compare by time only; id records the arrival order
+struct Event
+{
+  int time, id;
+  bool operator<(const Event &other) const { return time < other.time; }
+  bool operator==(const Event &other) const { return time == other.time && id == other.id; }
+};
+
+std::vector<Event> makeEvents(const std::string &shape, std::size_t n, std::mt19937 &gen)
+{
+  std::vector<Event> events(n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    int time = static_cast<int>(i);
+    if (shape == "random") { time = static_cast<int>(gen() % n); }
+    if (shape == "few_keys") { time = static_cast<int>(gen() % 4); }
+    if (shape == "reversed") { time = static_cast<int>(n - i) / 2; } // pairs of equal keys
+    if (shape == "sawtooth") { time = static_cast<int>(i % 1000); }
+    events[i] = {time, static_cast<int>(i)};
+  }
+  if (shape == "nearly_sorted")
+  {
+    // Local disorder: every element may arrive up to 20 positions late
+    for (std::size_t i = 0; i + 20 < n; i += 1 + gen() % 10)
+    {
+      std::swap(events[i], events[i + gen() % 20]);
+    }
+  }
+  if (shape == "appended")
+  {
+    std::sort(events.begin(), events.end() - n / 100);
+    std::shuffle(events.end() - n / 100, events.end(), gen);
+  }
+  return events;
+}
+
+const std::vector<std::string> kShapes = {"sorted", "nearly_sorted", "appended", "reversed", "sawtooth", "few_keys", "random"};
+
+TEST(power_sort_test, stable)
+{
+  std::mt19937 gen(1);
+  std::vector<Event> scratch;
+  for (const auto &shape : kShapes)
+  {
+    for (std::size_t n : {0, 1, 2, 23, 24, 25, 100, 1000, 54321})
+    {
+      std::vector<Event> events   = makeEvents(shape, n, gen);
+      std::vector<Event> expected = events;
+      std::stable_sort(expected.begin(), expected.end());
+      powerSort(events, scratch);
+      ASSERT_EQ(events, expected) << shape << ", n " << n;
+    }
+  }
+}
+
+TEST(power_sort_test, move_only)
+{
+  struct Boxed
+  {
+    std::unique_ptr<int> value;
+    bool operator<(const Boxed &other) const { return *value < *other.value; }
+  };
+
+  std::vector<Boxed> items;
+  for (int i = 0; i < 1000; ++i)
+  {
+    items.push_back({std::make_unique<int>((i * 7919) % 1000)});
+  }
+  powerSort(items);
+  for (int i = 0; i < 1000; ++i)
+  {
+    EXPECT_EQ(*items[i].value, i);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
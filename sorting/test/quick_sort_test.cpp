@@ -1,7 +1,9 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <iostream>
+#include <vector>
 
 #include "sorting/quick_sort/quick_sort.h"
 
@@ -26,6 +28,30 @@ TEST(quick_sort_test, test1)
   std::cout << std::endl;
 }
 
+TEST(quick_sort_test, sorted_and_duplicate_keys)
+{
+  // Inputs that made the last-element pivot quadratic
+  const std::size_t n = 200000;
+  std::vector<std::vector<double>> inputs(3, std::vector<double>(n));
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    inputs[0][i] = static_cast<double>(i);
+    inputs[1][i] = static_cast<double>(n - i);
+    inputs[2][i] = static_cast<double>(i % 3);
+  }
+  for (auto &input : inputs)
+  {
+    std::vector<double> expected = input;
+    std::sort(expected.begin(), expected.end());
+    quickSort(input, 0, input.size() - 1);
+    EXPECT_EQ(input, expected);
+  }
+
+  std::vector<int> a = {5, 4, 3, 2, 1};
+  quickSort(a, 1, 3);
+  EXPECT_EQ(a, std::vector<int>({5, 2, 3, 4, 1}));
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,89 @@
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+
+#include "sorting/intro_sort/intro_sort.h"
+#include "sorting/radix_sort/radix_sort.h"
+
+TEST(radix_sort_test, signed_integers)
+{
+  std::vector<int> a = {10, -7, 8, 0, -1, 5, std::numeric_limits<int>::min(), std::numeric_limits<int>::max()};
+  std::vector<int> b = a;
+  radixSort(a);
+  std::sort(b.begin(), b.end());
+  EXPECT_EQ(a, b);
+}
+
+TEST(radix_sort_test, floating_point_keys)
+{
+  std::vector<float> a = {0.5f, -0.25f, 3.0f, -7.5f, 0.0f, std::numeric_limits<float>::infinity(),
+                          -std::numeric_limits<float>::infinity(), 1e-30f, -1e-30f};
+  std::vector<float> b = a;
+  radixSort(a);
+  std::sort(b.begin(), b.end());
+  EXPECT_EQ(a, b);
+
+  std::mt19937_64 gen(2);
+  std::vector<double> c(10000);
+  for (auto &value : c)
+  {
+    value = std::normal_distribution<double>(0.0, 1e6)(gen);
+  }
+  std::vector<double> d = c;
+  radixSort(c);
+  std::sort(d.begin(), d.end());
+  EXPECT_EQ(c, d);
+}
+
+TEST(radix_sort_test, skipped_passes)
+{
+  // Only the lowest byte varies, so seven of the eight passes are skipped
+  std::vector<std::uint64_t> a = {200, 3, 17, 3, 255, 0, 64};
+  radixSort(a);
+  EXPECT_EQ(a, std::vector<std::uint64_t>({0, 3, 3, 17, 64, 200, 255}));
+}
+
+struct Stamped
+{
+  double stamp;
+  int id;
+};
+
+TEST(radix_sort_test, key_extractor_is_stable)
+{
+  std::vector<Stamped> a = {{2.5, 0}, {1.0, 1}, {2.5, 2}, {-1.0, 3}, {1.0, 4}};
+  radixSort(a, [](const Stamped &s) { return s.stamp; });
+  std::vector<int> ids;
+  for (const auto &s : a)
+  {
+    ids.push_back(s.id);
+  }
+  EXPECT_EQ(ids, std::vector<int>({3, 1, 4, 0, 2}));
+}
+
+TEST(radix_sort_test, parallel_histogram)
+{
+  std::mt19937 gen(4);
+  std::vector<std::int32_t> a(300000);
+  for (auto &value : a)
+  {
+    value = static_cast<std::int32_t>(gen());
+  }
+  std::vector<std::int32_t> b = a, c = a;
+  radixSort(a, 4);
+  radixSort(b, 1);
+  std::sort(c.begin(), c.end());
+  EXPECT_EQ(a, c);
+  EXPECT_EQ(b, c);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,96 @@
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+
+#include "sorting/search_index/search_index.h"
+
+// Reference answer: nearest key within threshold by a scan of the sorted keys, ties to the smaller key
+template <typename T>
+std::size_t nearestByScan(const std::vector<T> &sorted, T x, T threshold)
+{
+  std::size_t best = sorted.size();
+  for (std::size_t i = 0; i < sorted.size(); ++i)
+  {
+    T distance = sorted[i] < x ? x - sorted[i] : sorted[i] - x;
+    if (distance <= threshold && (best == sorted.size() || distance < (sorted[best] < x ? x - sorted[best] : sorted[best] - x)))
+    {
+      best = i;
+    }
+  }
+  return best;
+}
+
+TEST(search_index_test, lower_bound)
+{
+  std::mt19937 gen(1);
+  for (std::size_t n : {0, 1, 2, 3, 7, 8, 9, 15, 16, 17, 100, 1000, 4097})
+  {
+    std::vector<std::int32_t> keys(n);
+    for (auto &key : keys)
+    {
+      key = static_cast<std::int32_t>(gen() % (2 * n + 1)); // duplicates included
+    }
+    EytzingerIndex<std::int32_t> index(keys);
+    const std::vector<std::int32_t> &sorted = index.sorted();
+    ASSERT_TRUE(std::is_sorted(sorted.begin(), sorted.end()));
+
+    std::vector<std::int32_t> queries;
+    for (std::int32_t x = -2; x <= static_cast<std::int32_t>(2 * n + 2); ++x)
+    {
+      queries.push_back(x);
+    }
+    std::vector<std::size_t> batched = index.lowerBound(queries);
+    for (std::size_t i = 0; i < queries.size(); ++i)
+    {
+      std::size_t expected = std::lower_bound(sorted.begin(), sorted.end(), queries[i]) - sorted.begin();
+      ASSERT_EQ(index.lowerBound(queries[i]), expected) << "n " << n << ", x " << queries[i];
+      ASSERT_EQ(batched[i], expected) << "n " << n << ", x " << queries[i];
+    }
+  }
+}
+
+TEST(search_index_test, nearest)
+{
+  std::mt19937 gen(2);
+  for (std::size_t n : {0, 1, 5, 64, 333})
+  {
+    std::vector<double> keys(n), queries(500);
+    for (auto &key : keys)
+    {
+      key = std::uniform_real_distribution<double>(0.0, 1.0)(gen);
+    }
+    for (auto &query : queries)
+    {
+      query = std::uniform_real_distribution<double>(-0.1, 1.1)(gen);
+    }
+    queries.insert(queries.end(), keys.begin(), keys.end()); // exact hits
+
+    EytzingerIndex<double> index(keys);
+    for (double threshold : {0.0, 0.001, 0.05, 10.0})
+    {
+      std::vector<std::size_t> batched = index.nearest(queries, threshold);
+      for (std::size_t i = 0; i < queries.size(); ++i)
+      {
+        std::size_t expected = nearestByScan(index.sorted(), queries[i], threshold);
+        ASSERT_EQ(index.nearest(queries[i], threshold), expected) << "n " << n << ", x " << queries[i];
+        ASSERT_EQ(batched[i], expected);
+      }
+    }
+  }
+
+  // Equal distances go to the smaller key, also for unsigned keys
+  EytzingerIndex<std::uint32_t> index(std::vector<std::uint32_t>({10, 20, 30}));
+  EXPECT_EQ(index.nearest(15u, 5u), 0u);
+  EXPECT_EQ(index.nearest(26u, 5u), 2u);
+  EXPECT_EQ(index.nearest(0u, 5u), 3u);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,137 @@
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+
+#include "sorting/simd_sort/simd_sort.h"
+
+template <typename T>
+std::vector<T> randomKeys(std::size_t n, std::mt19937_64 &gen, std::int64_t range)
+{
+  std::vector<T> keys(n);
+  for (auto &key : keys)
+  {
+    key = static_cast<T>(static_cast<std::int64_t>(gen() % static_cast<std::uint64_t>(2 * range)) - range);
+  }
+  return keys;
+}
+
+// Every level up to the one this CPU supports
+std::vector<SimdLevel> testedLevels()
+{
+  std::vector<SimdLevel> levels = {SimdLevel::kScalar};
+  if (simdLevel() >= SimdLevel::kAvx2) { levels.push_back(SimdLevel::kAvx2); }
+  if (simdLevel() >= SimdLevel::kAvx512) { levels.push_back(SimdLevel::kAvx512); }
+  return levels;
+}
+
+template <typename T>
+void checkPartition()
+{
+  std::mt19937_64 gen(3);
+  for (SimdLevel level : testedLevels())
+  {
+    for (std::size_t n : {0, 1, 5, 8, 15, 16, 17, 31, 32, 33, 63, 100, 1000, 4097})
+    {
+      for (bool less_equal : {false, true})
+      {
+        std::vector<T> a = randomKeys<T>(n, gen, 50);
+        std::vector<T> b = a;
+        T pivot          = n > 0 ? a[n / 2] : T(0);
+        std::size_t k    = simdPartition(a.data(), n, pivot, less_equal, level);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+          bool lower = less_equal ? a[i] <= pivot : a[i] < pivot;
+          ASSERT_EQ(lower, i < k) << "n " << n << ", i " << i;
+        }
+        std::sort(a.begin(), a.end());
+        std::sort(b.begin(), b.end());
+        ASSERT_EQ(a, b); // a permutation of the input
+      }
+    }
+  }
+}
+
+template <typename T>
+void checkSort()
+{
+  std::mt19937_64 gen(5);
+  for (SimdLevel level : testedLevels())
+  {
+    for (std::size_t n : {0, 1, 2, 7, 16, 31, 32, 33, 64, 65, 1000, 20000})
+    {
+      std::vector<std::vector<T>> inputs = {randomKeys<T>(n, gen, 1 << 30), randomKeys<T>(n, gen, 3)};
+      std::vector<T> sorted(inputs[0]);
+      std::sort(sorted.begin(), sorted.end());
+      inputs.push_back(sorted);
+      inputs.emplace_back(sorted.rbegin(), sorted.rend());
+
+      for (auto &input : inputs)
+      {
+        std::vector<T> expected = input;
+        std::sort(expected.begin(), expected.end());
+        simdSort(input, level);
+        ASSERT_EQ(input, expected) << "n " << n << ", level " << static_cast<int>(level);
+      }
+    }
+  }
+}
+
+TEST(simd_sort_test, partition)
+{
+  checkPartition<float>();
+  checkPartition<double>();
+  checkPartition<std::int32_t>();
+  checkPartition<std::int64_t>();
+}
+
+TEST(simd_sort_test, network_sort)
+{
+  std::mt19937_64 gen(9);
+  for (SimdLevel level : testedLevels())
+  {
+    for (std::size_t n = 0; n <= simdLeafSize<float>(level); ++n)
+    {
+      std::vector<float> a = randomKeys<float>(n, gen, 1000);
+      std::vector<float> b = a;
+      simdNetworkSort(a.data(), n, level);
+      std::sort(b.begin(), b.end());
+      ASSERT_EQ(a, b);
+    }
+    for (std::size_t n = 0; n <= simdLeafSize<std::int64_t>(level); ++n)
+    {
+      std::vector<std::int64_t> a = randomKeys<std::int64_t>(n, gen, 1000);
+      std::vector<std::int64_t> b = a;
+      simdNetworkSort(a.data(), n, level);
+      std::sort(b.begin(), b.end());
+      ASSERT_EQ(a, b);
+    }
+  }
+}
+
+TEST(simd_sort_test, sort)
+{
+  checkSort<float>();
+  checkSort<double>();
+  checkSort<std::int32_t>();
+  checkSort<std::int64_t>();
+}
+
+TEST(simd_sort_test, generic_fallback)
+{
+  std::vector<std::string> a = {"pear", "apple", "fig", "kiwi"};
+  simdSort(a);
+  EXPECT_EQ(a, std::vector<std::string>({"apple", "fig", "kiwi", "pear"}));
+  EXPECT_FALSE(SimdSortSupported<std::string>::value);
+  EXPECT_EQ(simdLeafSize<std::string>(), 0u);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+
+#include "sorting/bfprt/bfprt.h"
+#include "sorting/intro_sort/intro_sort.h"
+#include "sorting/sort_network/sort_network.h"
+
+static_assert(SortNetwork<5>::kSize == 9 && SortNetwork<8>::kSize == 19, "merge-exchange is optimal up to 8");
+static_assert(medianNetwork(std::array<int, 5>{5, 1, 4, 2, 3}) == 3, "median networks run in constant expressions");
+
+constexpr std::array<double, 7> sortedAtCompileTime()
+{
+  std::array<double, 7> values = {7.0, -1.5, 3.0, 3.0, 0.0, 9.0, -4.0};
+  sortNetwork(values);
+  return values;
+}
+static_assert(sortedAtCompileTime()[0] == -4.0 && sortedAtCompileTime()[6] == 9.0, "sorting networks run in constant expressions");
+
+// 0-1 principle: a comparator network sorts every input iff it sorts every 0-1 input
+template <std::size_t N>
+void checkZeroOne()
+{
+  for (std::uint32_t mask = 0; mask < (std::uint32_t(1) << N); ++mask)
+  {
+    std::array<int, N> values;
+    for (std::size_t i = 0; i < N; ++i)
+    {
+      values[i] = (mask >> i) & 1;
+    }
+    std::array<int, N> median = values;
+    sortNetwork(values);
+    ASSERT_TRUE(std::is_sorted(values.begin(), values.end())) << "N = " << N << ", mask = " << mask;
+    ASSERT_EQ(medianNetwork<N>(median.data()), values[(N - 1) / 2]) << "N = " << N << ", mask = " << mask;
+  }
+}
+
+template <std::size_t... I>
+void checkZeroOne(std::index_sequence<I...>)
+{
+  (checkZeroOne<I + 1>(), ...);
+}
+
+// The comparators of Network applied to 64 0-1 inputs at once: bit j of wires[i] is input i of the j-th vector, so a
+// comparator is an AND (the minimum) and an OR (the maximum)
+template <typename Network, std::size_t N>
+void applyToLanes(std::array<std::uint64_t, N> &wires)
+{
+  for (const SortComparator &comparator : Network::kComparators)
+  {
+    const std::uint64_t low = wires[comparator.first] & wires[comparator.second];
+    wires[comparator.second] |= wires[comparator.first];
+    wires[comparator.first] = low;
+  }
+}
+
+// Check SortNetwork<N> and MedianNetwork<N> on the 64 0-1 inputs of wires
+template <std::size_t N>
+bool sortsLanes(const std::array<std::uint64_t, N> &wires)
+{
+  std::array<std::uint64_t, N> sorted = wires, median = wires;
+  applyToLanes<SortNetwork<N>>(sorted);
+  applyToLanes<MedianNetwork<N>>(median);
+  for (std::size_t i = 0; i + 1 < N; ++i)
+  {
+    if (sorted[i] & ~sorted[i + 1]) { return false; } // a 1 above a 0
+  }
+  return median[(N - 1) / 2] == sorted[(N - 1) / 2];
+}
+
+// Every 0-1 input up to kSortNetworkZeroOneExhaustive wires, 64 at a time; random 0-1 inputs above
+constexpr std::size_t kSortNetworkZeroOneExhaustive = 24;
+
+template <std::size_t N>
+void checkZeroOneLanes()
+{
+  // Wires below 6 enumerate the 64 lanes, the others the blocks of 64 inputs
+  constexpr std::uint64_t kLanePatterns[6] = {0xAAAAAAAAAAAAAAAAull, 0xCCCCCCCCCCCCCCCCull, 0xF0F0F0F0F0F0F0F0ull,
+                                               0xFF00FF00FF00FF00ull, 0xFFFF0000FFFF0000ull, 0xFFFFFFFF00000000ull};
+  std::array<std::uint64_t, N> wires;
+  if constexpr (N <= kSortNetworkZeroOneExhaustive)
+  {
+    const std::uint64_t blocks = N > 6 ? std::uint64_t(1) << (N - 6) : 1;
+    for (std::uint64_t block = 0; block < blocks; ++block)
+    {
+      for (std::size_t i = 0; i < N; ++i)
+      {
+        wires[i] = i < 6 ? kLanePatterns[i] : ((block >> (i - 6)) & 1 ? ~std::uint64_t(0) : 0);
+      }
+      ASSERT_TRUE(sortsLanes<N>(wires)) << "N = " << N << ", block = " << block;
+    }
+  }
+  else
+  {
+    std::mt19937_64 gen(N);
+    for (int trial = 0; trial < (1 << 16); ++trial)
+    {
+      for (auto &wire : wires)
+      {
+        wire = gen();
+      }
+      ASSERT_TRUE(sortsLanes<N>(wires)) << "N = " << N << ", trial = " << trial;
+    }
+  }
+}
+
+template <std::size_t... I>
+void checkZeroOneLanes(std::index_sequence<I...>)
+{
+  (checkZeroOneLanes<I + 1>(), ...);
+}
+
+// Random 0-1 inputs through the inlined networks themselves
+template <std::size_t N>
+void checkRandomZeroOne()
+{
+  std::mt19937_64 gen(N);
+  for (int trial = 0; trial < 2000; ++trial)
+  {
+    const std::uint64_t mask = gen();
+    std::array<int, N> values;
+    for (std::size_t i = 0; i < N; ++i)
+    {
+      values[i] = (mask >> i) & 1;
+    }
+    std::array<int, N> median = values;
+    sortNetwork(values);
+    ASSERT_TRUE(std::is_sorted(values.begin(), values.end())) << "N = " << N << ", mask = " << mask;
+    ASSERT_EQ(medianNetwork<N>(median.data()), values[(N - 1) / 2]) << "N = " << N << ", mask = " << mask;
+  }
+}
+
+template <std::size_t... I>
+void checkRandomZeroOne(std::index_sequence<I...>)
+{
+  (checkRandomZeroOne<I + 21>(), ...);
+}
+
+TEST(sort_network_test, zero_one_principle)
+{
+  checkZeroOne(std::make_index_sequence<20>());
+  checkRandomZeroOne(std::make_index_sequence<kSortNetworkMaxSize - 20>());
+
+  // Every shipped network: exhaustively up to 24 inputs, 2^22 random 0-1 inputs per size above
+  checkZeroOneLanes(std::make_index_sequence<kSortNetworkMaxSize>());
+}
+
+TEST(sort_network_test, random_inputs)
+{
+  std::mt19937 gen(1);
+  for (int trial = 0; trial < 2000; ++trial)
+  {
+    for (std::size_t n = 0; n <= kSortNetworkMaxSize; ++n)
+    {
+      std::vector<double> values(n), expected;
+      for (auto &value : values)
+      {
+        value = static_cast<double>(gen() % 16) - 8.0;
+      }
+      expected = values;
+      std::sort(expected.begin(), expected.end());
+      sortNetwork(values.data(), n);
+      ASSERT_EQ(values, expected);
+    }
+  }
+
+  std::vector<std::string> words = {"kiwi", "fig", "pear", "apple", "date", "fig", "lime"};
+  std::vector<std::string> expected = words;
+  std::sort(expected.begin(), expected.end());
+  sortNetwork<7>(words.data());
+  EXPECT_EQ(words, expected);
+}
+
+TEST(sort_network_test, sorts_and_selection_use_networks)
+{
+  std::mt19937 gen(2);
+  for (std::size_t n : {1, 5, 31, 33, 1000, 100000})
+  {
+    std::vector<float> values(n);
+    for (auto &value : values)
+    {
+      value = static_cast<float>(gen() % 1000);
+    }
+    std::vector<float> expected = values;
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<float> sorted = values;
+    introSort(sorted);
+    EXPECT_EQ(sorted, expected);
+
+    std::vector<float> selected = values;
+    EXPECT_EQ(select(selected, 0, n - 1, n / 3), expected[n / 3]);
+    selected = values;
+    nthElement(selected, n / 2);
+    EXPECT_EQ(selected[n / 2], expected[n / 2]);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,98 @@
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <set>
+
+#include "sorting/insert_sort/insert_sort.h"
+#include "sorting/sorted_vector/sorted_vector.h"
+
+TEST(sorted_vector_test, matches_multiset)
+{
+  std::mt19937 gen(1);
+  SortedVector<int> sorted;
+  std::multiset<int> expected;
+  for (int step = 0; step < 200000; ++step)
+  {
+    int value = static_cast<int>(gen() % 5000);
+    // Grow, then shrink, so chunks split and merge
+    if (gen() % 10 < (step < 120000 ? 7u : 2u))
+    {
+      sorted.insert(value);
+      expected.insert(value);
+    }
+    else
+    {
+      auto it = expected.find(value);
+      EXPECT_EQ(sorted.erase(value), it != expected.end());
+      if (it != expected.end()) { expected.erase(it); }
+    }
+
+    if (step % 10007 == 0)
+    {
+      ASSERT_EQ(sorted.size(), expected.size());
+      ASSERT_TRUE(std::equal(sorted.begin(), sorted.end(), expected.begin(), expected.end()));
+      std::size_t rank = 0;
+      for (int key : expected)
+      {
+        ASSERT_EQ(sorted[rank++], key);
+      }
+      for (int probe = -1; probe <= 5000; probe += 37)
+      {
+        std::size_t less = std::distance(expected.begin(), expected.lower_bound(probe));
+        ASSERT_EQ(sorted.rank(probe), less);
+        ASSERT_EQ(sorted.count(probe), expected.count(probe));
+        ASSERT_EQ(std::distance(sorted.begin(), sorted.lowerBound(probe)), static_cast<std::ptrdiff_t>(less));
+      }
+    }
+  }
+
+  while (!sorted.empty())
+  {
+    std::size_t rank = gen() % sorted.size();
+    auto it          = std::next(expected.begin(), rank);
+    EXPECT_EQ(sorted.select(rank), *it);
+    sorted.eraseRank(rank);
+    expected.erase(it);
+  }
+  EXPECT_EQ(sorted.begin(), sorted.end());
+}
+
+TEST(sorted_vector_test, stable_and_reverse_iteration)
+{
+  // Keys compare by the first member only, so the second records insertion order
+  struct Event
+  {
+    int time, id;
+    bool operator<(const Event &other) const { return time < other.time; }
+  };
+
+  SortedVector<Event> events;
+  for (int id = 0; id < 5000; ++id)
+  {
+    events.insert({(id * 7919) % 100, id});
+  }
+  int last_time = -1, last_id = -1;
+  for (const Event &event : events)
+  {
+    if (event.time == last_time) { EXPECT_LT(last_id, event.id); }
+    last_time = event.time;
+    last_id   = event.id;
+  }
+
+  std::size_t n = 0;
+  for (auto it = events.end(); it != events.begin(); ++n)
+  {
+    --it;
+  }
+  EXPECT_EQ(n, events.size());
+  EXPECT_EQ(std::distance(events.lowerBound({50, 0}), events.upperBound({50, 0})), 50);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,118 @@
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+
+#include "sorting/make_pair/make_pair.h"
+#include "sorting/stream_sync/stream_sync.h"
+
+// Timestamps of a sensor on a shared clock with the given period, jitter and dropout rate
+std::vector<double> sensorStream(double period, double duration, double jitter, std::mt19937 &gen)
+{
+  std::vector<double> stream;
+  for (double t = 0.0; t < duration; t += period)
+  {
+    if (gen() % 50 == 0) { continue; } // dropped sample
+    stream.push_back(t + std::uniform_real_distribution<double>(0.0, jitter)(gen));
+  }
+  return stream;
+}
+
+// Feed the streams in arrival order, each delivered with its own latency
+template <std::size_t N, typename Emit>
+void replay(StreamSynchronizer<double, N> &sync, const std::array<std::vector<double>, N> &streams,
+            const std::array<double, N> &latency, Emit &&emit)
+{
+  // (arrival time, (stream, timestamp))
+  std::vector<std::pair<double, std::pair<std::size_t, double>>> arrivals;
+  for (std::size_t j = 0; j < N; ++j)
+  {
+    for (double t : streams[j])
+    {
+      arrivals.push_back({t + latency[j], {j, t}});
+    }
+  }
+  std::stable_sort(arrivals.begin(), arrivals.end(),
+                   [](const auto &a, const auto &b) { return a.first < b.first; });
+  for (const auto &arrival : arrivals)
+  {
+    sync.push(arrival.second.first, arrival.second.second, emit);
+  }
+  sync.flush(emit);
+}
+
+TEST(stream_sync_test, matches_find_pairs)
+{
+  std::mt19937 gen(1);
+  const double thr                        = 0.004;
+  std::array<std::vector<double>, 4> data = {sensorStream(0.1, 60.0, 0.002, gen), sensorStream(1.0 / 30, 60.0, 0.003, gen),
+                                             sensorStream(0.005, 60.0, 0.0005, gen), sensorStream(0.05, 60.0, 0.004, gen)};
+
+  // Batch reference: pair the reference stream with every other stream, keep the reference times paired with all
+  std::map<double, std::array<double, 4>> expected;
+  for (double t : data[0])
+  {
+    expected[t][0] = t;
+  }
+  for (std::size_t j = 1; j < 4; ++j)
+  {
+    std::map<double, double> paired;
+    for (const auto &pair : findPairsOptimized(data[j], data[0], thr))
+    {
+      paired[pair.first] = pair.second;
+    }
+    for (auto it = expected.begin(); it != expected.end();)
+    {
+      auto match = paired.find(it->first);
+      if (match == paired.end()) { it = expected.erase(it); }
+      else
+      {
+        it->second[j] = match->second;
+        ++it;
+      }
+    }
+  }
+  ASSERT_GT(expected.size(), 50u);
+
+  for (const auto &latency : {std::array<double, 4>{0.0, 0.0, 0.0, 0.0}, std::array<double, 4>{0.03, 0.0, 0.12, 0.5}})
+  {
+    StreamSynchronizer<double, 4> sync(thr, 256);
+    std::vector<std::array<double, 4>> tuples;
+    replay(sync, data, latency, [&](const std::array<double, 4> &tuple) { tuples.push_back(tuple); });
+
+    ASSERT_EQ(tuples.size(), expected.size());
+    std::size_t i = 0;
+    for (const auto &item : expected)
+    {
+      EXPECT_EQ(tuples[i++], item.second);
+    }
+  }
+}
+
+TEST(stream_sync_test, bounded_rings)
+{
+  // A stalled stream makes the reference ring overflow; the oldest samples are resolved with what is at hand
+  StreamSynchronizer<int, 2> sync(1, 4);
+  std::vector<std::array<int, 2>> tuples;
+  auto emit = [&](const std::array<int, 2> &tuple) { tuples.push_back(tuple); };
+  sync.push(1, 0, emit);
+  for (int t = 0; t < 10; ++t)
+  {
+    sync.push(0, t, emit);
+  }
+  EXPECT_EQ(tuples, (std::vector<std::array<int, 2>>{{0, 0}, {1, 0}}));
+  sync.push(1, 9, emit);
+  EXPECT_EQ(tuples.size(), 4u); // 6 and 7 are too far from both samples; 8 and 9 match 9
+  EXPECT_EQ(tuples.back(), (std::array<int, 2>{9, 9}));
+  sync.flush(emit);
+  EXPECT_EQ(sync.emitted(), 4u);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,404 @@
+/*
+Benchmark suite of the statistics module: each estimator next to the approach it replaces, on sizes 10^3, 10^4, ...,
+up to --bench_max_size (10^7 by default).
+
+Benchmarks are named group/algorithm/size, e.g. reduction/parallelSum/1000000, so --benchmark_filter selects any
+slice. Items per second is the throughput in values (in points for covariance/, in samples for rolling/, where the
+size is the window and every run pushes kBenchRollingSamples samples). Cases that start threads, and the whole
+reduction/ group so that its rows compare, are timed in wall-clock time. JSON for regression tracking:
+
+  statistics_bench --benchmark_out=statistics_bench.json --benchmark_out_format=json
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "common/parallel_for.h"
+#include "geometry/common.h"
+#include "sorting/bfprt/bfprt.h"
+#include "statistics/covariance_matrix/covariance_matrix.h"
+#include "statistics/quantile_sketch/quantile_sketch.h"
+#include "statistics/reduction/reduction.h"
+#include "statistics/robust/robust.h"
+#include "statistics/rolling_stats/rolling_stats.h"
+#include "statistics/welford/welford.h"
+
+using namespace math::statistics;
+
+// Largest size when --bench_max_size is not given
+constexpr std::size_t kBenchDefaultMaxSize = 10000000;
+// Samples pushed through every window of the rolling benchmarks
+constexpr std::size_t kBenchRollingSamples = 200000;
+// Proportion cut from each end by the trimmed means
+constexpr double kBenchTrim = 0.1;
+
+// n draws of distribution; the same seed gives the same values
+template <typename Distribution>
+std::vector<double> benchValues(std::size_t n, Distribution distribution, std::uint64_t seed)
+{
+  std::mt19937_64 gen(seed);
+  std::vector<double> values(n);
+  for (auto &value : values)
+  {
+    value = distribution(gen);
+  }
+  return values;
+}
+
+std::vector<double> uniformValues(std::size_t n, double low, double high, std::uint64_t seed)
+{
+  return benchValues(n, std::uniform_real_distribution<double>(low, high), seed);
+}
+
+// Register group/algorithm/n; body runs the timing loop, and every iteration processes n items
+void registerBench(const std::string &group, const std::string &algorithm, std::size_t n,
+                   std::function<void(benchmark::State &)> body, bool real_time = false)
+{
+  const std::string name = group + "/" + algorithm + "/" + std::to_string(n);
+  auto *bench            = benchmark::RegisterBenchmark(name.c_str(), [=](benchmark::State &state) {
+    body(state);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * n));
+  });
+  if (real_time) { bench->UseRealTime(); }
+}
+
+// Covariance of two columns: the three-pass formula, one accumulator, per-thread accumulators merged
+void registerMoments(std::size_t n)
+{
+  registerBench("moments", "threePass", n, [n](benchmark::State &state) {
+    const std::vector<double> x = uniformValues(n, 0.0, 1.0, 2), y = uniformValues(n, 0.0, 1.0, 3);
+    for (auto _ : state)
+    {
+      const double mean_x = std::accumulate(x.begin(), x.end(), 0.0) / n;
+      const double mean_y = std::accumulate(y.begin(), y.end(), 0.0) / n;
+      double c            = 0.0;
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        c += (x[i] - mean_x) * (y[i] - mean_y);
+      }
+      benchmark::DoNotOptimize(c / n);
+    }
+  });
+  registerBench("moments", "CovarianceAccumulator", n, [n](benchmark::State &state) {
+    const std::vector<double> x = uniformValues(n, 0.0, 1.0, 2), y = uniformValues(n, 0.0, 1.0, 3);
+    for (auto _ : state)
+    {
+      CovarianceAccumulator<double> accumulator;
+      accumulator.add(x.begin(), x.end(), y.begin());
+      benchmark::DoNotOptimize(accumulator.covariance());
+    }
+  });
+  registerBench(
+      "moments", "CovarianceAccumulator::merge", n,
+      [n](benchmark::State &state) {
+        const std::vector<double> x = uniformValues(n, 0.0, 1.0, 2), y = uniformValues(n, 0.0, 1.0, 3);
+        const std::size_t threads   = bmath::defaultThreadCount();
+        for (auto _ : state)
+        {
+          std::vector<CovarianceAccumulator<double>> partial(threads);
+          std::vector<std::thread> workers;
+          for (std::size_t t = 0; t < threads; ++t)
+          {
+            workers.emplace_back([&, t]() {
+              partial[t].add(x.begin() + n * t / threads, x.begin() + n * (t + 1) / threads, y.begin() + n * t / threads);
+            });
+          }
+          for (auto &worker : workers)
+          {
+            worker.join();
+          }
+          CovarianceAccumulator<double> merged;
+          for (const auto &accumulator : partial)
+          {
+            merged.merge(accumulator);
+          }
+          benchmark::DoNotOptimize(merged.covariance());
+        }
+      },
+      true);
+}
+
+// Sums and moments of values with a large common offset
+void registerReductions(std::size_t n)
+{
+  const std::vector<std::pair<const char *, std::function<double(const std::vector<double> &)>>> sums = {
+      {"std::accumulate", [](const std::vector<double> &x) { return std::accumulate(x.begin(), x.end(), 0.0); }},
+      {"parallelSum<1>", [](const std::vector<double> &x) { return parallelSum(x, 1); }},
+      {"parallelSum", [](const std::vector<double> &x) { return parallelSum(x); }},
+      {"parallelVariance", [](const std::vector<double> &x) { return parallelVariance(x); }},
+  };
+  for (const auto &c : sums)
+  {
+    const auto sum = c.second;
+    registerBench(
+        "reduction", c.first, n,
+        [n, sum](benchmark::State &state) {
+          const std::vector<double> x = uniformValues(n, 1e8 - 1.0, 1e8 + 1.0, 3);
+          for (auto _ : state)
+          {
+            benchmark::DoNotOptimize(sum(x));
+          }
+        },
+        true);
+  }
+  registerBench(
+      "reduction", "parallelCovariance", n,
+      [n](benchmark::State &state) {
+        const std::vector<double> x = uniformValues(n, 1e8 - 1.0, 1e8 + 1.0, 3), y = uniformValues(n, 1e8 - 1.0, 1e8 + 1.0, 4);
+        for (auto _ : state)
+        {
+          benchmark::DoNotOptimize(parallelCovariance(x, y));
+        }
+      },
+      true);
+}
+
+// n points uniform in [-1, 1)^3
+std::vector<bmath::geometry::PointXYZ> uniformPoints(std::size_t n)
+{
+  const std::vector<double> coordinates = uniformValues(3 * n, -1.0, 1.0, 4);
+  std::vector<bmath::geometry::PointXYZ> points(n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    points[i] = {coordinates[3 * i], coordinates[3 * i + 1], coordinates[3 * i + 2]};
+  }
+  return points;
+}
+
+// 3 x 3 covariance of n points: six pairwise passes, Eigen on the mapped coordinates, covarianceMatrix
+void registerCovarianceMatrices(std::size_t n)
+{
+  registerBench("covariance", "pairwise", n, [n](benchmark::State &state) {
+    const std::vector<bmath::geometry::PointXYZ> points = uniformPoints(n);
+    const auto get = [](const bmath::geometry::PointXYZ &p, int d) { return d == 0 ? p.x : (d == 1 ? p.y : p.z); };
+    for (auto _ : state)
+    {
+      Eigen::Matrix3d pairwise;
+      for (int i = 0; i < 3; ++i)
+      {
+        for (int j = i; j < 3; ++j)
+        {
+          double mean_i = 0.0, mean_j = 0.0, c = 0.0;
+          for (const auto &point : points)
+          {
+            mean_i += get(point, i);
+            mean_j += get(point, j);
+          }
+          mean_i /= n;
+          mean_j /= n;
+          for (const auto &point : points)
+          {
+            c += (get(point, i) - mean_i) * (get(point, j) - mean_j);
+          }
+          pairwise(i, j) = pairwise(j, i) = c / n;
+        }
+      }
+      benchmark::DoNotOptimize(pairwise.data());
+    }
+  });
+  registerBench("covariance", "Eigen", n, [n](benchmark::State &state) {
+    const std::vector<bmath::geometry::PointXYZ> points = uniformPoints(n);
+    for (auto _ : state)
+    {
+      Eigen::Map<const Eigen::Matrix3Xd> columns(&points[0].x, 3, static_cast<Eigen::Index>(n));
+      const Eigen::Vector3d mean = columns.rowwise().mean();
+      const Eigen::Matrix3d gram = (columns.colwise() - mean) * (columns.colwise() - mean).transpose() / n;
+      benchmark::DoNotOptimize(gram.data());
+    }
+  });
+  registerBench("covariance", "covarianceMatrix<1>", n, [n](benchmark::State &state) {
+    const std::vector<bmath::geometry::PointXYZ> points = uniformPoints(n);
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(covarianceMatrix(points, 1).covariance().data());
+    }
+  });
+  registerBench(
+      "covariance", "covarianceMatrix", n,
+      [n](benchmark::State &state) {
+        const std::vector<bmath::geometry::PointXYZ> points = uniformPoints(n);
+        for (auto _ : state)
+        {
+          benchmark::DoNotOptimize(covarianceMatrix(points).covariance().data());
+        }
+      },
+      true);
+}
+
+// Quantiles of exponential values: building the sketch, querying it, and the exact nthElement it stands in for
+void registerQuantiles(std::size_t n)
+{
+  const std::vector<double> quantiles = {0.5, 0.9, 0.99, 0.999};
+  const auto generate                 = [n]() { return benchValues(n, std::exponential_distribution<double>(1.0), 3); };
+  registerBench("quantile", "QuantileSketch::add", n, [generate](benchmark::State &state) {
+    const std::vector<double> data = generate();
+    for (auto _ : state)
+    {
+      QuantileSketch<double> sketch;
+      for (double value : data)
+      {
+        sketch.add(value);
+      }
+      benchmark::DoNotOptimize(sketch.retained());
+    }
+  });
+  registerBench("quantile", "QuantileSketch::quantile", n, [generate, quantiles](benchmark::State &state) {
+    QuantileSketch<double> sketch;
+    for (double value : generate())
+    {
+      sketch.add(value);
+    }
+    for (auto _ : state)
+    {
+      for (double q : quantiles)
+      {
+        benchmark::DoNotOptimize(sketch.quantile(q));
+      }
+    }
+  });
+  registerBench("quantile", "nthElement", n, [generate, quantiles, n](benchmark::State &state) {
+    const std::vector<double> data = generate();
+    std::vector<double> work(n);
+    for (auto _ : state)
+    {
+      for (double q : quantiles)
+      {
+        std::copy(data.begin(), data.end(), work.begin());
+        nthElement(work, static_cast<std::size_t>(q * (n - 1)));
+        benchmark::DoNotOptimize(work.data());
+      }
+    }
+  });
+}
+
+// Robust estimators of lognormal values against sorting a copy
+void registerRobust(std::size_t n)
+{
+  const auto generate   = [n]() { return benchValues(n, std::lognormal_distribution<double>(0.0, 1.0), 3); };
+  const std::size_t cut = static_cast<std::size_t>(kBenchTrim * n);
+  const std::vector<std::pair<const char *, std::function<double(std::vector<double> &)>>> sorted = {
+      {"sort+median", [n](std::vector<double> &v) { return (v[(n - 1) / 2] + v[n / 2]) / 2.0; }},
+      {"sort+trimmedMean",
+       [n, cut](std::vector<double> &v) { return std::accumulate(v.begin() + cut, v.end() - cut, 0.0) / (n - 2 * cut); }},
+  };
+  for (const auto &c : sorted)
+  {
+    const auto estimate = c.second;
+    registerBench("robust", c.first, n, [generate, estimate](benchmark::State &state) {
+      const std::vector<double> data = generate();
+      std::vector<double> work(data.size());
+      for (auto _ : state)
+      {
+        std::copy(data.begin(), data.end(), work.begin());
+        std::sort(work.begin(), work.end());
+        benchmark::DoNotOptimize(estimate(work));
+      }
+    });
+  }
+
+  // The estimator keeps its scratch buffers across iterations, as a caller reusing it would
+  const std::vector<std::pair<const char *, std::function<double(RobustEstimator<double> &, const std::vector<double> &)>>>
+      selected = {
+          {"median", [](RobustEstimator<double> &e, const std::vector<double> &v) { return e.median(v); }},
+          {"trimmedMean", [](RobustEstimator<double> &e, const std::vector<double> &v) { return e.trimmedMean(v, kBenchTrim); }},
+          {"mad", [](RobustEstimator<double> &e, const std::vector<double> &v) { return e.mad(v); }},
+      };
+  for (const auto &c : selected)
+  {
+    const auto estimate = c.second;
+    registerBench("robust", c.first, n, [generate, estimate](benchmark::State &state) {
+      const std::vector<double> data = generate();
+      RobustEstimator<double> estimator;
+      estimate(estimator, data);
+      for (auto _ : state)
+      {
+        benchmark::DoNotOptimize(estimate(estimator, data));
+      }
+    });
+  }
+}
+
+// Variance, minimum and maximum of the last window samples after every sample: copying the window into an Eigen
+// vector, against RollingStatistics
+void registerRolling(std::size_t window)
+{
+  const auto bench = [window](const char *algorithm, std::function<void(benchmark::State &, const std::vector<float> &)> body) {
+    const std::string name = std::string("rolling/") + algorithm + "/" + std::to_string(window);
+    benchmark::RegisterBenchmark(name.c_str(), [body](benchmark::State &state) {
+      const std::vector<double> values = uniformValues(kBenchRollingSamples, 0.0, 1.0, 3);
+      body(state, std::vector<float>(values.begin(), values.end()));
+      state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * kBenchRollingSamples));
+    });
+  };
+  bench("copyWindow", [window](benchmark::State &state, const std::vector<float> &stream) {
+    for (auto _ : state)
+    {
+      double sum = 0.0;
+      for (std::size_t i = window; i < stream.size(); ++i)
+      {
+        const Eigen::VectorXf copy =
+            Eigen::Map<const Eigen::VectorXf>(stream.data() + i - window + 1, static_cast<Eigen::Index>(window));
+        const float mean = copy.mean();
+        sum += (copy.array() - mean).square().sum() / window + copy.minCoeff() + copy.maxCoeff();
+      }
+      benchmark::DoNotOptimize(sum);
+    }
+  });
+  bench("RollingStatistics", [window](benchmark::State &state, const std::vector<float> &stream) {
+    for (auto _ : state)
+    {
+      RollingStatistics<float> rolling(window);
+      double sum = 0.0;
+      for (std::size_t i = 0; i < stream.size(); ++i)
+      {
+        rolling.push(stream[i]);
+        if (i >= window) { sum += rolling.variance() + rolling.min() + rolling.max(); }
+      }
+      benchmark::DoNotOptimize(sum);
+    }
+  });
+}
+
+int main(int argc, char **argv)
+{
+  // Take --bench_max_size=N out of the arguments before Google Benchmark parses them
+  std::size_t max_size = kBenchDefaultMaxSize;
+  int kept             = 1;
+  for (int i = 1; i < argc; ++i)
+  {
+    const char *flag = "--bench_max_size=";
+    if (std::strncmp(argv[i], flag, std::strlen(flag)) == 0) { max_size = std::strtoull(argv[i] + std::strlen(flag), nullptr, 10); }
+    else { argv[kept++] = argv[i]; }
+  }
+  argc = kept;
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) { return 1; }
+  for (std::size_t n = 1000; n <= max_size; n *= 10)
+  {
+    registerMoments(n);
+    registerReductions(n);
+    registerCovarianceMatrices(n);
+    registerQuantiles(n);
+    registerRobust(n);
+  }
+  for (std::size_t window = 16; window <= std::min(max_size, kBenchRollingSamples / 4); window *= 16)
+  {
+    registerRolling(window);
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
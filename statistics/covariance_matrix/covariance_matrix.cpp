@@ -0,0 +1,2 @@
+
+#include "statistics/covariance_matrix/covariance_matrix.h"
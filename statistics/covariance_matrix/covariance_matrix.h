@@ -0,0 +1,287 @@
+#ifndef STATISTICS_COVARIANCE_MATRIX_H
+#define STATISTICS_COVARIANCE_MATRIX_H
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "common/parallel_for.h"
+#include "geometry/common.h"
+#include "statistics/welford/welford.h"
+
+namespace math
+{
+namespace statistics
+{
+/*
+D x D covariance of a set of N points in D dimensions, in one pass over the points.
+
+Points are copied in blocks of kWelfordBlockSize into a coordinate-major buffer on the stack. While the block is in
+L1 its mean is subtracted and the D (D + 1) / 2 co-moments are formed as dot products of contiguous coordinate rows,
+which the compiler vectorizes; the block is then merged into the running result with the Chan update of
+welford.h. Threads each accumulate a contiguous slice of the points and their results are merged in slice order.
+
+|property|description|
+|---|---|
+|Layouts|std::vector<PointXYZ>; Eigen matrices with one point per column (Matrix3Xd) or per row (MatrixX3f); one pointer per coordinate (SoA); any callable coordinate(i, d).|
+|Passes|one over the points, every coordinate read once.|
+|Memory|D * kWelfordBlockSize scalars of stack per thread; no heap allocation on one thread.|
+|Precision|accumulates in double by default, also for float input; stable under a large common offset.|
+|Threads|0 means defaultThreadCount(); slices below kCovarianceParallelMinPoints stay on the calling thread.|
+
+For D = 3, covariance(C) fills a plain Scalar C[3][3], the argument of linear_algebra::powerIteration.
+*/
+
+// Fewest points per thread worth starting a thread for
+constexpr std::size_t kCovarianceParallelMinPoints = std::size_t(1) << 16;
+
+template <int D, typename T = double>
+class CovarianceMatrixAccumulator
+{
+ public:
+  using Vector = Eigen::Matrix<T, D, 1>;
+  using Matrix = Eigen::Matrix<T, D, D>;
+
+  // Welford update with one point of D coordinates
+  template <typename S>
+  void add(const S *point)
+  {
+    ++count_;
+    T delta[D];
+    for (int d = 0; d < D; ++d)
+    {
+      delta[d] = static_cast<T>(point[d]) - mean_[d];
+      mean_[d] += delta[d] / static_cast<T>(count_);
+    }
+    for (int i = 0; i < D; ++i)
+    {
+      for (int j = i; j < D; ++j)
+      {
+        m_[i][j] += delta[i] * (static_cast<T>(point[j]) - mean_[j]);
+      }
+    }
+  }
+
+  // m <= kWelfordBlockSize points stored coordinate by coordinate, block[d * kWelfordBlockSize + k]; centered in place
+  void addBlock(T *block, std::size_t m)
+  {
+    if (m == 0) { return; }
+    CovarianceMatrixAccumulator part;
+    part.count_ = m;
+    for (int d = 0; d < D; ++d)
+    {
+      T *row        = block + d * kWelfordBlockSize;
+      part.mean_[d] = blockSum(row, m) / static_cast<T>(m);
+      for (std::size_t k = 0; k < m; ++k)
+      {
+        row[k] -= part.mean_[d];
+      }
+    }
+    for (int i = 0; i < D; ++i)
+    {
+      for (int j = i; j < D; ++j)
+      {
+        part.m_[i][j] = blockDot(block + i * kWelfordBlockSize, block + j * kWelfordBlockSize, m);
+      }
+    }
+    merge(part);
+  }
+
+  // Add points [first, last); coordinate(i, d) is coordinate d of point i
+  template <typename Coordinate>
+  void add(std::size_t first, std::size_t last, const Coordinate &coordinate)
+  {
+    T block[D * kWelfordBlockSize];
+    while (first < last)
+    {
+      const std::size_t m = std::min(kWelfordBlockSize, last - first);
+      for (std::size_t k = 0; k < m; ++k)
+      {
+        for (int d = 0; d < D; ++d)
+        {
+          block[d * kWelfordBlockSize + k] = static_cast<T>(coordinate(first + k, d));
+        }
+      }
+      addBlock(block, m);
+      first += m;
+    }
+  }
+
+  void merge(const CovarianceMatrixAccumulator &other)
+  {
+    if (other.count_ == 0) { return; }
+    if (count_ == 0)
+    {
+      *this = other;
+      return;
+    }
+    const T n      = static_cast<T>(count_ + other.count_);
+    const T weight = static_cast<T>(count_) * static_cast<T>(other.count_) / n;
+    T delta[D];
+    for (int d = 0; d < D; ++d)
+    {
+      delta[d] = other.mean_[d] - mean_[d];
+      mean_[d] += delta[d] * static_cast<T>(other.count_) / n;
+    }
+    for (int i = 0; i < D; ++i)
+    {
+      for (int j = i; j < D; ++j)
+      {
+        m_[i][j] += other.m_[i][j] + delta[i] * delta[j] * weight;
+      }
+    }
+    count_ += other.count_;
+  }
+
+  std::uint64_t count() const { return count_; }
+
+  Vector mean() const
+  {
+    Vector mean;
+    for (int d = 0; d < D; ++d)
+    {
+      mean(d) = mean_[d];
+    }
+    return mean;
+  }
+
+  // Sums of products of deviations from the mean
+  Matrix comoments() const
+  {
+    Matrix comoments;
+    for (int i = 0; i < D; ++i)
+    {
+      for (int j = i; j < D; ++j)
+      {
+        comoments(i, j) = comoments(j, i) = m_[i][j];
+      }
+    }
+    return comoments;
+  }
+
+  // Population covariance (divide by n)
+  Matrix covariance() const { return comoments() / static_cast<T>(count_); }
+  Matrix sampleCovariance() const { return comoments() / (static_cast<T>(count_) - T(1)); }
+
+  template <typename Scalar>
+  void covariance(Scalar C[D][D]) const
+  {
+    for (int i = 0; i < D; ++i)
+    {
+      for (int j = i; j < D; ++j)
+      {
+        C[i][j] = C[j][i] = static_cast<Scalar>(m_[i][j] / static_cast<T>(count_));
+      }
+    }
+  }
+
+ private:
+  // Four partial sums so the additions pipeline and vectorize without reassociating a single chain
+  static T blockSum(const T *a, std::size_t m)
+  {
+    T s[4] = {T(0), T(0), T(0), T(0)};
+    std::size_t k = 0;
+    for (; k + 4 <= m; k += 4)
+    {
+      s[0] += a[k];
+      s[1] += a[k + 1];
+      s[2] += a[k + 2];
+      s[3] += a[k + 3];
+    }
+    for (; k < m; ++k)
+    {
+      s[0] += a[k];
+    }
+    return (s[0] + s[1]) + (s[2] + s[3]);
+  }
+
+  static T blockDot(const T *a, const T *b, std::size_t m)
+  {
+    T s[4] = {T(0), T(0), T(0), T(0)};
+    std::size_t k = 0;
+    for (; k + 4 <= m; k += 4)
+    {
+      s[0] += a[k] * b[k];
+      s[1] += a[k + 1] * b[k + 1];
+      s[2] += a[k + 2] * b[k + 2];
+      s[3] += a[k + 3] * b[k + 3];
+    }
+    for (; k < m; ++k)
+    {
+      s[0] += a[k] * b[k];
+    }
+    return (s[0] + s[1]) + (s[2] + s[3]);
+  }
+
+  std::uint64_t count_ = 0;
+  T mean_[D]           = {};
+  T m_[D][D]           = {}; // upper triangle
+};
+
+// Covariance of n points given by coordinate(i, d), split over num_threads slices merged in order
+template <int D, typename T = double, typename Coordinate>
+CovarianceMatrixAccumulator<D, T> covarianceMatrix(std::size_t n, const Coordinate &coordinate, std::size_t num_threads = 0)
+{
+  if (num_threads == 0) { num_threads = bmath::defaultThreadCount(); }
+  num_threads = std::max<std::size_t>(1, std::min(num_threads, n / kCovarianceParallelMinPoints));
+
+  CovarianceMatrixAccumulator<D, T> result;
+  if (num_threads == 1)
+  {
+    result.add(0, n, coordinate);
+    return result;
+  }
+  std::vector<CovarianceMatrixAccumulator<D, T>> partial(num_threads);
+  bmath::parallelFor(num_threads, [&](std::size_t t) { partial[t].add(n * t / num_threads, n * (t + 1) / num_threads, coordinate); });
+  for (const auto &part : partial)
+  {
+    result.merge(part);
+  }
+  return result;
+}
+
+// Array of PointXYZ
+template <typename T = double>
+CovarianceMatrixAccumulator<3, T> covarianceMatrix(const std::vector<bmath::geometry::PointXYZ> &points,
+                                                   std::size_t num_threads = 0)
+{
+  const bmath::geometry::PointXYZ *data = points.data();
+  return covarianceMatrix<3, T>(
+      points.size(),
+      [data](std::size_t i, int d) { return d == 0 ? data[i].x : (d == 1 ? data[i].y : data[i].z); }, num_threads);
+}
+
+// Eigen matrix with a fixed number of rows and one point per column (Matrix3Xd), or a fixed number of columns and one
+// point per row (MatrixX3f)
+template <typename T = double, typename Derived>
+auto covarianceMatrix(const Eigen::DenseBase<Derived> &points, std::size_t num_threads = 0)
+{
+  constexpr bool kPointsInColumns = Derived::RowsAtCompileTime != Eigen::Dynamic;
+  constexpr int D                 = kPointsInColumns ? Derived::RowsAtCompileTime : Derived::ColsAtCompileTime;
+  static_assert(D != Eigen::Dynamic, "the dimension must be fixed at compile time: Matrix3Xd or MatrixX3f");
+  static_assert(!kPointsInColumns || Derived::ColsAtCompileTime == Eigen::Dynamic,
+                "ambiguous layout: one of rows and columns must be dynamic");
+  const Derived &matrix = points.derived();
+  if constexpr (kPointsInColumns)
+  {
+    return covarianceMatrix<D, T>(
+        static_cast<std::size_t>(matrix.cols()), [&matrix](std::size_t i, int d) { return matrix(d, i); }, num_threads);
+  }
+  return covarianceMatrix<D, T>(
+      static_cast<std::size_t>(matrix.rows()), [&matrix](std::size_t i, int d) { return matrix(i, d); }, num_threads);
+}
+
+// Structure of arrays: coordinates[d][i] is coordinate d of point i
+template <int D, typename T = double, typename S>
+CovarianceMatrixAccumulator<D, T> covarianceMatrix(const std::array<const S *, D> &coordinates, std::size_t n,
+                                                   std::size_t num_threads = 0)
+{
+  return covarianceMatrix<D, T>(n, [&coordinates](std::size_t i, int d) { return coordinates[d][i]; }, num_threads);
+}
+} // namespace statistics
+} // namespace math
+
+#endif
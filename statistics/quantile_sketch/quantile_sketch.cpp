@@ -0,0 +1,2 @@
+
+#include "statistics/quantile_sketch/quantile_sketch.h"
@@ -0,0 +1,2 @@
+
+#include "statistics/reduction/reduction.h"
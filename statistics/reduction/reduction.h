@@ -0,0 +1,279 @@
+#ifndef STATISTICS_REDUCTION_H
+#define STATISTICS_REDUCTION_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "common/parallel_for.h"
+#include "statistics/welford/welford.h"
+
+namespace math
+{
+namespace statistics
+{
+/*
+Parallel sum, mean, variance and covariance with compensated summation, bit-identical for any number of threads.
+
+The input is cut into chunks of kReductionChunkSize values, a size that does not depend on the thread count. Each chunk
+is reduced on its own with kReductionLanes interleaved TwoSum accumulators (Knuth; the branch-free form of
+Kahan-Babuska-Neumaier summation), which carry the rounding error of every addition in a separate compensation term.
+Threads take contiguous runs of chunks, and the chunk results are then combined by a fixed pairwise tree over the
+chunk index. Which thread reduced a chunk never enters the arithmetic, so 1 thread and 64 threads return the same bits.
+
+For variance and covariance every value is first shifted by the first value of the input, so chunk means are small and
+keep their precision when chunks merge. A chunk is read twice: the first pass sums it for the chunk mean, and the
+second pass sums the deviations from that mean together with their squares and products, all in one loop (the
+corrected two-pass algorithm). A chunk of doubles is 16 KiB, 32 KiB for the two inputs of a covariance, so the
+second pass reads from L1 and main memory is read once. The chunks merge with the Chan update of welford.h.
+
+|property|description|
+|---|---|
+|Error|sum: O(eps) relative to sum(abs(x)) instead of O(n eps); variance: stable under a large mean.|
+|Determinism|bit-identical results for every num_threads, for a given input and build.|
+|Memory|one small result per chunk (n / 2048 of them).|
+|Threads|0 means defaultThreadCount().|
+
+Results are double for float and double input. Empty input throws std::invalid_argument from mean, variance and
+covariance; the sum of nothing is 0.
+*/
+
+// Values per chunk: the unit of work and the leaves of the reduction tree
+constexpr std::size_t kReductionChunkSize = 2048;
+// Interleaved accumulators per chunk, enough to hide the latency of the running sums
+constexpr std::size_t kReductionLanes = 8;
+
+// s + e == a + b exactly, with s = fl(a + b)
+inline void twoSum(double a, double b, double &s, double &e)
+{
+  s               = a + b;
+  const double bb = s - a;
+  e               = (a - (s - bb)) + (b - bb);
+}
+
+// A sum and the accumulated rounding error of its additions
+struct CompensatedSum
+{
+  double sum          = 0.0;
+  double compensation = 0.0;
+
+  void add(double value)
+  {
+    double error;
+    twoSum(sum, value, sum, error);
+    compensation += error;
+  }
+
+  void merge(const CompensatedSum &other)
+  {
+    add(other.sum);
+    compensation += other.compensation;
+  }
+
+  double value() const { return sum + compensation; }
+};
+
+// Compensated sum of f(i) for i in [first, last), in kReductionLanes interleaved lanes merged in a fixed order
+template <typename Function>
+CompensatedSum compensatedSum(std::size_t first, std::size_t last, const Function &f)
+{
+  double sum[kReductionLanes] = {}, compensation[kReductionLanes] = {};
+  std::size_t i = first;
+  for (; i + kReductionLanes <= last; i += kReductionLanes)
+  {
+    for (std::size_t lane = 0; lane < kReductionLanes; ++lane)
+    {
+      const double value = f(i + lane);
+      const double s     = sum[lane] + value;
+      const double bb    = s - sum[lane];
+      compensation[lane] += (sum[lane] - (s - bb)) + (value - bb);
+      sum[lane] = s;
+    }
+  }
+  CompensatedSum result;
+  for (std::size_t lane = 0; lane < kReductionLanes; ++lane)
+  {
+    result.merge(CompensatedSum{sum[lane], compensation[lane]});
+  }
+  for (; i < last; ++i)
+  {
+    result.add(f(i));
+  }
+  return result;
+}
+
+// Compensated sums of the K components of f(i) (an std::array<double, K>) for i in [first, last), in one loop. The
+// kReductionLanes accumulator pairs are shared between the components, and lanes merge in a fixed order.
+template <std::size_t K, typename Function>
+std::array<CompensatedSum, K> compensatedSums(std::size_t first, std::size_t last, const Function &f)
+{
+  constexpr std::size_t kLanes = std::max<std::size_t>(1, kReductionLanes / K);
+  double sum[K][kLanes] = {}, compensation[K][kLanes] = {};
+  std::size_t i = first;
+  for (; i + kLanes <= last; i += kLanes)
+  {
+    for (std::size_t lane = 0; lane < kLanes; ++lane)
+    {
+      const std::array<double, K> values = f(i + lane);
+      for (std::size_t j = 0; j < K; ++j)
+      {
+        const double s  = sum[j][lane] + values[j];
+        const double bb = s - sum[j][lane];
+        compensation[j][lane] += (sum[j][lane] - (s - bb)) + (values[j] - bb);
+        sum[j][lane] = s;
+      }
+    }
+  }
+  std::array<CompensatedSum, K> result;
+  for (std::size_t j = 0; j < K; ++j)
+  {
+    for (std::size_t lane = 0; lane < kLanes; ++lane)
+    {
+      result[j].merge(CompensatedSum{sum[j][lane], compensation[j][lane]});
+    }
+  }
+  for (; i < last; ++i)
+  {
+    const std::array<double, K> values = f(i);
+    for (std::size_t j = 0; j < K; ++j)
+    {
+      result[j].add(values[j]);
+    }
+  }
+  return result;
+}
+
+// Reduce every chunk of [0, n) with chunk(first, last) on num_threads threads, then merge the results pairwise in a
+// fixed tree: the shape of the tree depends on n only
+template <typename Result, typename Chunk>
+Result reduceChunks(std::size_t n, std::size_t num_threads, const Chunk &chunk)
+{
+  const std::size_t chunks = (n + kReductionChunkSize - 1) / kReductionChunkSize;
+  if (chunks == 0) { return Result(); }
+  if (num_threads == 0) { num_threads = bmath::defaultThreadCount(); }
+  num_threads = std::min(num_threads, chunks);
+
+  std::vector<Result> results(chunks);
+  bmath::parallelFor(num_threads, [&](std::size_t t) {
+    for (std::size_t c = chunks * t / num_threads; c < chunks * (t + 1) / num_threads; ++c)
+    {
+      results[c] = chunk(c * kReductionChunkSize, std::min(n, (c + 1) * kReductionChunkSize));
+    }
+  });
+  for (std::size_t width = 1; width < chunks; width *= 2)
+  {
+    for (std::size_t c = 0; c + width < chunks; c += 2 * width)
+    {
+      results[c].merge(results[c + width]);
+    }
+  }
+  return results[0];
+}
+
+template <typename T>
+double parallelSum(const T *data, std::size_t n, std::size_t num_threads = 0)
+{
+  return reduceChunks<CompensatedSum>(n, num_threads, [data](std::size_t first, std::size_t last) {
+           return compensatedSum(first, last, [data](std::size_t i) { return static_cast<double>(data[i]); });
+         })
+      .value();
+}
+
+template <typename T>
+double parallelMean(const T *data, std::size_t n, std::size_t num_threads = 0)
+{
+  if (n == 0) { throw std::invalid_argument("Vector must be non-empty."); }
+  return parallelSum(data, n, num_threads) / static_cast<double>(n);
+}
+
+// Count, mean and M2 of the values; variance() and sampleVariance() of the result give the moments
+template <typename T>
+WelfordAccumulator<double> parallelMoments(const T *data, std::size_t n, std::size_t num_threads = 0)
+{
+  if (n == 0) { return WelfordAccumulator<double>(); }
+  const double shift = static_cast<double>(data[0]);
+  auto shifted       = [data, shift](std::size_t i) { return static_cast<double>(data[i]) - shift; };
+  const WelfordAccumulator<double> moments =
+      reduceChunks<WelfordAccumulator<double>>(n, num_threads, [&shifted](std::size_t first, std::size_t last) {
+        const double m    = static_cast<double>(last - first);
+        const double mean = compensatedSum(first, last, shifted).value() / m;
+        // Second pass, from cache: deviations and their squares together
+        const auto sums = compensatedSums<2>(first, last, [&shifted, mean](std::size_t i) {
+          const double d = shifted(i) - mean;
+          return std::array<double, 2>{d, d * d};
+        });
+        const double sum = sums[0].value();
+        return WelfordAccumulator<double>::fromMoments(last - first, mean + sum / m, sums[1].value() - sum * sum / m);
+      });
+  return WelfordAccumulator<double>::fromMoments(moments.count(), moments.mean() + shift, moments.m2());
+}
+
+// Population variance
+template <typename T>
+double parallelVariance(const T *data, std::size_t n, std::size_t num_threads = 0)
+{
+  if (n == 0) { throw std::invalid_argument("Vector must be non-empty."); }
+  return parallelMoments(data, n, num_threads).variance();
+}
+
+// Population covariance of the pairs (x[i], y[i])
+template <typename T>
+double parallelCovariance(const T *x, const T *y, std::size_t n, std::size_t num_threads = 0)
+{
+  if (n == 0) { throw std::invalid_argument("Vectors must be non-empty."); }
+  const double shift_x = static_cast<double>(x[0]);
+  const double shift_y = static_cast<double>(y[0]);
+  auto shifted_x       = [x, shift_x](std::size_t i) { return static_cast<double>(x[i]) - shift_x; };
+  auto shifted_y       = [y, shift_y](std::size_t i) { return static_cast<double>(y[i]) - shift_y; };
+  return reduceChunks<CovarianceAccumulator<double>>(n, num_threads, [&](std::size_t first, std::size_t last) {
+           const double m     = static_cast<double>(last - first);
+           const auto means   = compensatedSums<2>(first, last, [&](std::size_t i) {
+             return std::array<double, 2>{shifted_x(i), shifted_y(i)};
+           });
+           const double mean_x = means[0].value() / m;
+           const double mean_y = means[1].value() / m;
+           // Second pass, from cache: both deviation sums and the three products together
+           const auto sums = compensatedSums<5>(first, last, [&](std::size_t i) {
+             const double dx = shifted_x(i) - mean_x;
+             const double dy = shifted_y(i) - mean_y;
+             return std::array<double, 5>{dx, dy, dx * dx, dy * dy, dx * dy};
+           });
+           const double sx = sums[0].value(), sy = sums[1].value();
+           const double sxx = sums[2].value(), syy = sums[3].value(), sxy = sums[4].value();
+           return CovarianceAccumulator<double>::fromMoments(last - first, mean_x + sx / m, mean_y + sy / m,
+                                                             sxx - sx * sx / m, syy - sy * sy / m, sxy - sx * sy / m);
+         })
+      .covariance();
+}
+
+template <typename T>
+double parallelSum(const std::vector<T> &data, std::size_t num_threads = 0)
+{
+  return parallelSum(data.data(), data.size(), num_threads);
+}
+
+template <typename T>
+double parallelMean(const std::vector<T> &data, std::size_t num_threads = 0)
+{
+  return parallelMean(data.data(), data.size(), num_threads);
+}
+
+template <typename T>
+double parallelVariance(const std::vector<T> &data, std::size_t num_threads = 0)
+{
+  return parallelVariance(data.data(), data.size(), num_threads);
+}
+
+template <typename T>
+double parallelCovariance(const std::vector<T> &x, const std::vector<T> &y, std::size_t num_threads = 0)
+{
+  if (x.size() != y.size()) { throw std::invalid_argument("Vectors must be of the same size and non-empty."); }
+  return parallelCovariance(x.data(), y.data(), x.size(), num_threads);
+}
+} // namespace statistics
+} // namespace math
+
+#endif
@@ -0,0 +1,2 @@
+
+#include "statistics/robust/robust.h"
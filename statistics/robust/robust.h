@@ -0,0 +1,177 @@
+#ifndef STATISTICS_ROBUST_H
+#define STATISTICS_ROBUST_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "sorting/bfprt/bfprt.h"
+#include "statistics/reduction/reduction.h"
+
+namespace math
+{
+namespace statistics
+{
+/*
+Robust location and scale estimators in linear time: median, median absolute deviation, trimmed and winsorized mean.
+
+None of them needs the data sorted, only a few order statistics: the values are copied into a scratch buffer and
+nthElement (sorting/bfprt: introselect with a median-of-medians fallback) places the ranks that are needed. A trimmed
+mean selects its lower cut and then its upper cut inside the part above it, after which the kept values are exactly
+the middle of the buffer. The input is never modified.
+
+|estimator|selections|breakdown point|
+|---|---|---|
+|median|1 (2 for even n)|50%|
+|mad|2 medians, of the values and of the absolute deviations|50%|
+|trimmedMean(p)|2, at ranks floor(p n) and n - 1 - floor(p n)|p|
+|winsorizedMean(p)|2, the same ranks|p|
+
+|property|description|
+|---|---|
+|Time|expected O(n) per estimator with a small constant. O(n) worst case, because nthElement switches to median-of-medians pivots after a constant number of bad partitions.|
+|Memory|the scratch buffers of a RobustEstimator grow to the largest input and are reused, so repeated calls do not allocate.|
+|Sums|compensated (reduction.h), so trimmed means of large arrays stay accurate.|
+
+Empty input and trim proportions outside [0, 0.5) throw std::invalid_argument. NaN values are not supported.
+*/
+
+// MAD times this estimates the standard deviation of normally distributed data
+constexpr double kMadNormalScale = 1.482602218505602;
+
+template <typename T>
+class RobustEstimator
+{
+ public:
+  // Median; the mean of the two middle values for even n
+  double median(const T *data, std::size_t n)
+  {
+    load(data, n);
+    return selectMedian(scratch_, n);
+  }
+
+  // Median absolute deviation from the median, unscaled; multiply by kMadNormalScale for a standard deviation
+  double mad(const T *data, std::size_t n)
+  {
+    const double center = median(data, n);
+    // Deviations from a median halfway between two integers are not integers: keep them in double
+    if (deviations_.size() < n) { deviations_.resize(n); }
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      deviations_[i] = std::abs(static_cast<double>(data[i]) - center);
+    }
+    return selectMedian(deviations_, n);
+  }
+
+  // Mean of the values left after dropping floor(proportion * n) from each end
+  double trimmedMean(const T *data, std::size_t n, double proportion)
+  {
+    T low{}, high{};
+    const std::size_t cut  = trim(data, n, proportion, low, high);
+    const std::size_t kept = n - 2 * cut;
+    return middleSum(cut, n - cut).value() / static_cast<double>(kept);
+  }
+
+  // Mean after replacing the floor(proportion * n) values at each end by the nearest value that is kept
+  double winsorizedMean(const T *data, std::size_t n, double proportion)
+  {
+    T low{}, high{};
+    const std::size_t cut = trim(data, n, proportion, low, high);
+    CompensatedSum sum    = middleSum(cut, n - cut);
+    if (cut > 0)
+    {
+      sum.add(static_cast<double>(cut) * static_cast<double>(low));
+      sum.add(static_cast<double>(cut) * static_cast<double>(high));
+    }
+    return sum.value() / static_cast<double>(n);
+  }
+
+  double median(const std::vector<T> &data) { return median(data.data(), data.size()); }
+  double mad(const std::vector<T> &data) { return mad(data.data(), data.size()); }
+  double trimmedMean(const std::vector<T> &data, double proportion)
+  {
+    return trimmedMean(data.data(), data.size(), proportion);
+  }
+  double winsorizedMean(const std::vector<T> &data, double proportion)
+  {
+    return winsorizedMean(data.data(), data.size(), proportion);
+  }
+
+  // Capacity of the scratch buffer, in values
+  std::size_t capacity() const { return scratch_.size(); }
+
+ private:
+  // Copy data into the scratch buffer, growing it only when n exceeds every earlier input
+  void load(const T *data, std::size_t n)
+  {
+    if (n == 0) { throw std::invalid_argument("Vector must be non-empty."); }
+    if (scratch_.size() < n) { scratch_.resize(n); }
+    std::copy(data, data + n, scratch_.begin());
+  }
+
+  // Median of the first n values of buffer, which is reordered
+  template <typename U>
+  static double selectMedian(std::vector<U> &buffer, std::size_t n)
+  {
+    const std::size_t upper = n / 2;
+    nthElement(buffer, 0, n - 1, upper);
+    if (n % 2 == 1) { return static_cast<double>(buffer[upper]); }
+    // The lower middle value is the largest of the part that selection left below the upper one
+    const U lower = *std::max_element(buffer.begin(), buffer.begin() + upper);
+    return (static_cast<double>(lower) + static_cast<double>(buffer[upper])) / 2.0;
+  }
+
+  // Place the ranks cut and n - 1 - cut, so that [cut, n - cut) holds exactly the kept values, and return cut with
+  // the values of both ranks in low and high
+  std::size_t trim(const T *data, std::size_t n, double proportion, T &low, T &high)
+  {
+    if (!(proportion >= 0.0 && proportion < 0.5)) { throw std::invalid_argument("Trim proportion must be in [0, 0.5)."); }
+    load(data, n);
+    const std::size_t cut = static_cast<std::size_t>(proportion * static_cast<double>(n));
+    if (cut == 0) { return 0; }
+    nthElement(scratch_, 0, n - 1, cut);
+    low = scratch_[cut]; // the second selection may move it within [cut, n)
+    nthElement(scratch_, cut, n - 1, n - 1 - cut);
+    high = scratch_[n - 1 - cut];
+    return cut;
+  }
+
+  CompensatedSum middleSum(std::size_t first, std::size_t last) const
+  {
+    const T *values = scratch_.data();
+    return compensatedSum(first, last, [values](std::size_t i) { return static_cast<double>(values[i]); });
+  }
+
+  std::vector<T> scratch_;
+  std::vector<double> deviations_;
+};
+
+template <typename T>
+double median(const std::vector<T> &data)
+{
+  return RobustEstimator<T>().median(data);
+}
+
+template <typename T>
+double mad(const std::vector<T> &data)
+{
+  return RobustEstimator<T>().mad(data);
+}
+
+template <typename T>
+double trimmedMean(const std::vector<T> &data, double proportion)
+{
+  return RobustEstimator<T>().trimmedMean(data, proportion);
+}
+
+template <typename T>
+double winsorizedMean(const std::vector<T> &data, double proportion)
+{
+  return RobustEstimator<T>().winsorizedMean(data, proportion);
+}
+} // namespace statistics
+} // namespace math
+
+#endif
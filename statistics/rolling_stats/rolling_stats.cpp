@@ -0,0 +1,2 @@
+
+#include "statistics/rolling_stats/rolling_stats.h"
@@ -0,0 +1,156 @@
+#ifndef STATISTICS_ROLLING_STATS_H
+#define STATISTICS_ROLLING_STATS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace math
+{
+namespace statistics
+{
+/*
+Mean, variance, min and max of the last W values of a stream.
+
+The window is a ring buffer. Pushing into a full window replaces the oldest value, and the mean and M2 are updated by
+removing it and adding the new one in a single Welford step, so a tick is O(1) whatever W is. Min and max come from
+two monotonic deques of positions in the stream: the min deque holds increasing values, the max deque decreasing ones,
+and a position leaves the front once it falls out of the window.
+
+|property|description|
+|---|---|
+|push|O(1) amortized; each position enters and leaves each deque once.|
+|Queries|mean, variance, min, max in O(1).|
+|Memory|the W values and two deques of W positions, allocated once in the constructor.|
+|Drift|the add/remove updates accumulate rounding; every renormalize_every pushes (W by default, 0 to never) mean and M2 are recomputed from the window in two passes, O(1) amortized.|
+
+Empty windows return T() for min and max and NaN for the moments.
+*/
+template <typename T = double>
+class RollingStatistics
+{
+ public:
+  explicit RollingStatistics(std::size_t window, std::size_t renormalize_every = std::size_t(-1)) :
+    window_(window), renormalize_every_(renormalize_every == std::size_t(-1) ? window : renormalize_every)
+  {
+    if (window == 0) { throw std::invalid_argument("Window must hold at least one value."); }
+    values_.resize(window);
+    min_queue_.resize(window);
+    max_queue_.resize(window);
+  }
+
+  void push(T value)
+  {
+    const double x = static_cast<double>(value);
+    if (size_ < window_)
+    {
+      ++size_;
+      const double delta = x - mean_;
+      mean_ += delta / static_cast<double>(size_);
+      m2_ += delta * (x - mean_);
+    }
+    else
+    {
+      // Remove the oldest value and add the new one in one step
+      const double oldest   = static_cast<double>(values_[slot_]);
+      const double old_mean = mean_;
+      mean_ += (x - oldest) / static_cast<double>(window_);
+      m2_ += (x - oldest) * (x - mean_ + oldest - old_mean);
+      if (m2_ < 0.0) { m2_ = 0.0; }
+    }
+    values_[slot_] = value;
+
+    pushQueue(min_queue_, min_front_, min_size_, [&](T kept) { return kept < value; });
+    pushQueue(max_queue_, max_front_, max_size_, [&](T kept) { return value < kept; });
+    ++next_;
+    slot_ = wrap(slot_ + 1);
+
+    if (renormalize_every_ != 0 && ++since_renormalize_ >= renormalize_every_) { renormalize(); }
+  }
+
+  // Recompute mean and M2 from the values in the window
+  void renormalize()
+  {
+    since_renormalize_ = 0;
+    if (size_ == 0) { return; }
+    double sum = 0.0;
+    for (std::size_t i = 0; i < size_; ++i)
+    {
+      sum += static_cast<double>(values_[i]);
+    }
+    mean_ = sum / static_cast<double>(size_);
+    m2_   = 0.0;
+    for (std::size_t i = 0; i < size_; ++i)
+    {
+      const double delta = static_cast<double>(values_[i]) - mean_;
+      m2_ += delta * delta;
+    }
+  }
+
+  void clear()
+  {
+    size_ = slot_ = next_ = since_renormalize_ = 0;
+    min_front_ = min_size_ = max_front_ = max_size_ = 0;
+    mean_ = m2_ = 0.0;
+  }
+
+  std::size_t window() const { return window_; }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  bool full() const { return size_ == window_; }
+  // Values pushed since construction or clear()
+  std::uint64_t pushed() const { return next_; }
+
+  double mean() const { return size_ == 0 ? std::numeric_limits<double>::quiet_NaN() : mean_; }
+  double variance() const { return m2_ / static_cast<double>(size_); }
+  double sampleVariance() const { return m2_ / (static_cast<double>(size_) - 1.0); }
+  T min() const { return min_size_ == 0 ? T() : values_[slotOf(min_queue_[min_front_])]; }
+  T max() const { return max_size_ == 0 ? T() : values_[slotOf(max_queue_[max_front_])]; }
+
+ private:
+  // i mod window for i < 2 * window, without a division
+  std::size_t wrap(std::size_t i) const { return i >= window_ ? i - window_ : i; }
+
+  // Ring slot of stream position p, for p in the current window or equal to next_
+  std::size_t slotOf(std::uint64_t p) const
+  {
+    const std::size_t back = static_cast<std::size_t>(next_ - p);
+    return slot_ >= back ? slot_ - back : slot_ + window_ - back;
+  }
+
+  // Drop the expired front and the back positions that can no longer be the extreme, then append position next_
+  template <typename Dominated>
+  void pushQueue(std::vector<std::uint64_t> &queue, std::size_t &front, std::size_t &size, Dominated dominated)
+  {
+    if (size > 0 && queue[front] + window_ <= next_)
+    {
+      front = wrap(front + 1);
+      --size;
+    }
+    while (size > 0 && !dominated(values_[slotOf(queue[wrap(front + size - 1)])]))
+    {
+      --size;
+    }
+    queue[wrap(front + size)] = next_;
+    ++size;
+  }
+
+  std::size_t window_;
+  std::size_t renormalize_every_;
+  std::vector<T> values_;
+  std::vector<std::uint64_t> min_queue_, max_queue_;
+  std::size_t min_front_ = 0, min_size_ = 0;
+  std::size_t max_front_ = 0, max_size_ = 0;
+  std::size_t size_              = 0;
+  std::size_t slot_              = 0; // ring slot of position next_
+  std::uint64_t next_            = 0;
+  std::size_t since_renormalize_ = 0;
+  double mean_                   = 0.0;
+  double m2_                     = 0.0;
+};
+} // namespace statistics
+} // namespace math
+
+#endif
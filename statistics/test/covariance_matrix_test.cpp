@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "linear_algebra/eigen/eigen.h"
+#include "statistics/covariance_matrix/covariance_matrix.h"
+
+using bmath::geometry::PointXYZ;
+using math::statistics::covarianceMatrix;
+
+// Two-pass reference: mean, then the centered Gram matrix
+template <typename Derived>
+Eigen::MatrixXd referenceCovariance(const Eigen::MatrixBase<Derived> &columns)
+{
+  Eigen::MatrixXd points   = columns.template cast<double>();
+  Eigen::VectorXd mean     = points.rowwise().mean();
+  Eigen::MatrixXd centered = points.colwise() - mean;
+  return centered * centered.transpose() / static_cast<double>(points.cols());
+}
+
+TEST(covariance_matrix_test, layouts_agree)
+{
+  std::mt19937_64 gen(1);
+  std::normal_distribution<double> normal(0.0, 1.0);
+  const std::size_t n = 100003;
+  Eigen::Matrix3Xd columns(3, n);
+  std::vector<PointXYZ> points(n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    double a = normal(gen), b = normal(gen), c = normal(gen);
+    points[i] = {1000.0 + a, -50.0 + 2.0 * a + b, 0.1 * c - a};
+    columns.col(i) << points[i].x, points[i].y, points[i].z;
+  }
+  Eigen::MatrixXd expected = referenceCovariance(columns);
+
+  auto aos = covarianceMatrix(points);
+  EXPECT_EQ(aos.count(), n);
+  EXPECT_TRUE(aos.covariance().isApprox(expected, 1e-12));
+  EXPECT_TRUE(aos.mean().isApprox(columns.rowwise().mean(), 1e-12));
+  EXPECT_TRUE(covarianceMatrix(columns).covariance().isApprox(expected, 1e-12));
+
+  Eigen::MatrixX3f rows = columns.transpose().cast<float>();
+  EXPECT_TRUE(covarianceMatrix(rows).covariance().isApprox(referenceCovariance(rows.transpose()), 1e-10));
+
+  // Sample covariance and the plain array for powerIteration
+  EXPECT_TRUE(aos.sampleCovariance().isApprox(expected * n / (n - 1.0), 1e-12));
+  double C[3][3];
+  aos.covariance(C);
+  EXPECT_NEAR(C[0][1], expected(1, 0), 1e-12);
+  EXPECT_NEAR(C[2][0], expected(0, 2), 1e-12);
+
+  // One Welford update per point gives the same result
+  math::statistics::CovarianceMatrixAccumulator<3> streamed;
+  for (const auto &point : points)
+  {
+    double coordinates[3] = {point.x, point.y, point.z};
+    streamed.add(coordinates);
+  }
+  EXPECT_TRUE(streamed.covariance().isApprox(expected, 1e-10));
+}
+
+TEST(covariance_matrix_test, soa_six_dimensions_and_threads)
+{
+  std::mt19937_64 gen(2);
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  const std::size_t n = 1 << 19;
+  Eigen::Matrix<double, 6, Eigen::Dynamic, Eigen::RowMajor> soa(6, n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    for (int d = 0; d < 6; ++d)
+    {
+      soa(d, i) = uniform(gen) + (d > 0 ? 0.5 * soa(d - 1, i) : 0.0);
+    }
+  }
+  std::array<const double *, 6> coordinates;
+  for (int d = 0; d < 6; ++d)
+  {
+    coordinates[d] = soa.row(d).data();
+  }
+  Eigen::MatrixXd expected = referenceCovariance(soa);
+
+  for (std::size_t threads : {1, 2, 3, 8})
+  {
+    auto result = covarianceMatrix<6>(coordinates, n, threads);
+    EXPECT_EQ(result.count(), n);
+    EXPECT_TRUE(result.covariance().isApprox(expected, 1e-12)) << threads << " threads";
+  }
+
+  // Shards merge like the whole set
+  auto first  = covarianceMatrix<6>(std::array<const double *, 6>{}, 0);
+  auto second = covarianceMatrix<6>(coordinates, n);
+  first.merge(second);
+  EXPECT_TRUE(first.covariance().isApprox(expected, 1e-12));
+}
+
+TEST(covariance_matrix_test, normal_and_principal_direction)
+{
+  std::mt19937_64 gen(3);
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  const Eigen::Vector3d normal = Eigen::Vector3d(1.0, 2.0, 2.0).normalized();
+  const Eigen::Vector3d u      = normal.unitOrthogonal();
+  const Eigen::Vector3d v      = normal.cross(u);
+  std::vector<PointXYZ> plane(20000);
+  for (auto &point : plane)
+  {
+    // A noisy patch, long along u
+    Eigen::Vector3d p = 5.0 * uniform(gen) * u + uniform(gen) * v + 0.01 * uniform(gen) * normal;
+    point             = {p.x(), p.y(), p.z()};
+  }
+
+  auto result = covarianceMatrix(plane);
+  Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver(result.covariance());
+  EXPECT_GT(std::abs(solver.eigenvectors().col(0).dot(normal)), 0.9999);
+
+  double C[3][3], direction[3];
+  result.covariance(C);
+  bmath::linear_algebra::powerIteration(C, direction, 1000, 1e-12);
+  EXPECT_GT(std::abs(Eigen::Vector3d(direction[0], direction[1], direction[2]).dot(u)), 0.9999);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+#include "sorting/bfprt/bfprt.h"
+#include "statistics/quantile_sketch/quantile_sketch.h"
+
+// Largest |estimated quantile rank - q| over a grid of q, measured against the sorted data
+template <typename T>
+double maxRankError(const math::statistics::QuantileSketch<T> &sketch, const std::vector<T> &sorted)
+{
+  double worst = 0.0;
+  for (double q = 0.01; q < 1.0; q += 0.01)
+  {
+    T estimate   = sketch.quantile(q);
+    double lower = static_cast<double>(std::lower_bound(sorted.begin(), sorted.end(), estimate) - sorted.begin());
+    double upper = static_cast<double>(std::upper_bound(sorted.begin(), sorted.end(), estimate) - sorted.begin());
+    double n     = static_cast<double>(sorted.size());
+    double error = 0.0;
+    if (q * n < lower) { error = (lower - q * n) / n; }
+    if (q * n > upper) { error = (q * n - upper) / n; }
+    worst = std::max(worst, error);
+  }
+  return worst;
+}
+
+TEST(quantile_sketch_test, small_stream_is_exact)
+{
+  math::statistics::QuantileSketch<int> sketch;
+  for (int i = 1; i <= 100; ++i)
+  {
+    sketch.add(i);
+  }
+  EXPECT_EQ(sketch.count(), 100u);
+  EXPECT_EQ(sketch.quantile(0.0), 1);
+  EXPECT_EQ(sketch.quantile(0.5), 50);
+  EXPECT_EQ(sketch.quantile(0.99), 99);
+  EXPECT_EQ(sketch.quantile(1.0), 100);
+  EXPECT_DOUBLE_EQ(sketch.rank(25), 0.25);
+}
+
+TEST(quantile_sketch_test, rank_error_bound)
+{
+  std::mt19937_64 gen(1);
+  std::vector<double> data(1000000);
+  for (auto &value : data)
+  {
+    value = std::lognormal_distribution<double>(0.0, 1.0)(gen);
+  }
+
+  math::statistics::QuantileSketch<double> sketch(200);
+  for (double value : data)
+  {
+    sketch.add(value);
+  }
+  std::sort(data.begin(), data.end());
+
+  double error = maxRankError(sketch, data);
+  std::cout << "retained " << sketch.retained() << " of " << sketch.count() << ", max rank error " << error << std::endl;
+  EXPECT_LT(sketch.retained(), 1000u);
+  EXPECT_LT(error, 0.02); // every quantile of the grid at once
+  EXPECT_EQ(sketch.quantile(0.0), data.front());
+  EXPECT_EQ(sketch.quantile(1.0), data.back());
+}
+
+TEST(quantile_sketch_test, single_query_bound)
+{
+  // The 0.85% bound holds for 99% of sketches at one quantile: count independent sketches that miss it
+  std::mt19937_64 gen(4);
+  std::vector<double> data(100000);
+  for (auto &value : data)
+  {
+    value = std::uniform_real_distribution<double>(0.0, 1.0)(gen);
+  }
+  std::vector<double> sorted = data;
+  std::sort(sorted.begin(), sorted.end());
+
+  const int sketches = 100;
+  int misses         = 0;
+  for (int seed = 0; seed < sketches; ++seed)
+  {
+    math::statistics::QuantileSketch<double> sketch(200, static_cast<std::uint64_t>(seed));
+    for (double value : data)
+    {
+      sketch.add(value);
+    }
+    double estimate = sketch.quantile(0.5);
+    double rank     = static_cast<double>(std::lower_bound(sorted.begin(), sorted.end(), estimate) - sorted.begin());
+    if (std::abs(rank / data.size() - 0.5) > 0.0085) { ++misses; }
+  }
+  std::cout << misses << " of " << sketches << " sketches above 0.85% at the median" << std::endl;
+  EXPECT_LE(misses, 5) << misses << " of " << sketches << " sketches missed the single-query bound";
+}
+
+TEST(quantile_sketch_test, merge)
+{
+  std::mt19937_64 gen(2);
+  std::vector<double> data;
+  std::vector<math::statistics::QuantileSketch<double>> shards;
+  for (std::uint64_t s = 0; s < 8; ++s)
+  {
+    shards.emplace_back(200, s);
+    for (int i = 0; i < 100000; ++i)
+    {
+      double value = std::normal_distribution<double>(static_cast<double>(s), 1.0)(gen);
+      shards.back().add(value);
+      data.push_back(value);
+    }
+  }
+
+  math::statistics::QuantileSketch<double> merged;
+  for (const auto &shard : shards)
+  {
+    merged.merge(shard);
+  }
+  std::sort(data.begin(), data.end());
+
+  EXPECT_EQ(merged.count(), data.size());
+  EXPECT_LT(maxRankError(merged, data), 0.02);
+}
+
+TEST(quantile_sketch_test, merge_with_itself)
+{
+  std::mt19937_64 gen(3);
+  std::vector<double> data;
+  math::statistics::QuantileSketch<double> sketch(200, 3);
+  for (int i = 0; i < 100000; ++i)
+  {
+    double value = std::uniform_real_distribution<double>(0.0, 1.0)(gen);
+    sketch.add(value);
+    data.push_back(value);
+    data.push_back(value);
+  }
+  std::sort(data.begin(), data.end());
+
+  sketch.merge(sketch);
+  EXPECT_EQ(sketch.count(), data.size());
+  EXPECT_LT(maxRankError(sketch, data), 0.02);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "statistics/reduction/reduction.h"
+
+using namespace math::statistics;
+
+// Exact bit pattern, so that -0.0 and 0.0 or two NaNs are told apart
+bool sameBits(double a, double b)
+{
+  return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+long double referenceSum(const std::vector<double> &data)
+{
+  long double sum = 0.0L;
+  for (double value : data)
+  {
+    sum += value;
+  }
+  return sum;
+}
+
+TEST(reduction_test, compensated_sum)
+{
+  // 1 + 10^100 + 1 - 10^100: plain summation returns 0
+  std::vector<double> data = {1.0, 1e100, 1.0, -1e100};
+  EXPECT_EQ(std::accumulate(data.begin(), data.end(), 0.0), 0.0);
+  EXPECT_EQ(parallelSum(data), 2.0);
+
+  double s, e;
+  twoSum(1.0, 1e-17, s, e);
+  EXPECT_EQ(s, 1.0);
+  EXPECT_EQ(e, 1e-17);
+
+  EXPECT_EQ(parallelSum(std::vector<double>()), 0.0);
+  EXPECT_THROW(parallelMean(std::vector<double>()), std::invalid_argument);
+  EXPECT_THROW(parallelCovariance(std::vector<double>(3), std::vector<double>(4)), std::invalid_argument);
+
+  std::vector<float> floats(10001, 0.1f);
+  EXPECT_NEAR(parallelSum(floats), 10001 * static_cast<double>(0.1f), 1e-9);
+}
+
+TEST(reduction_test, bit_identical_for_any_thread_count)
+{
+  std::mt19937_64 gen(1);
+  std::vector<double> x(1000003), y(x.size());
+  for (std::size_t i = 0; i < x.size(); ++i)
+  {
+    x[i] = std::exp(std::uniform_real_distribution<double>(-20.0, 20.0)(gen)) * (gen() % 2 ? 1.0 : -1.0);
+    y[i] = 1e6 + std::normal_distribution<double>(0.0, 1.0)(gen);
+  }
+
+  const double sum        = parallelSum(x, 1);
+  const double variance   = parallelVariance(y, 1);
+  const double covariance = parallelCovariance(x, y, 1);
+  for (std::size_t threads : {2, 3, 7, 16, 64})
+  {
+    EXPECT_TRUE(sameBits(parallelSum(x, threads), sum)) << threads << " threads";
+    EXPECT_TRUE(sameBits(parallelVariance(y, threads), variance)) << threads << " threads";
+    EXPECT_TRUE(sameBits(parallelCovariance(x, y, threads), covariance)) << threads << " threads";
+  }
+  EXPECT_NEAR(sum, static_cast<double>(referenceSum(x)), 1e-15 * std::abs(sum));
+}
+
+TEST(reduction_test, moments_match_reference)
+{
+  std::mt19937_64 gen(2);
+  std::vector<double> x(300001), y(x.size());
+  for (std::size_t i = 0; i < x.size(); ++i)
+  {
+    x[i] = 1e9 + std::normal_distribution<double>(0.0, 2.0)(gen);
+    y[i] = -3.0 * (x[i] - 1e9) + std::normal_distribution<double>(0.0, 1.0)(gen);
+  }
+  long double mean_x = 0.0L, mean_y = 0.0L;
+  for (std::size_t i = 0; i < x.size(); ++i)
+  {
+    mean_x += x[i];
+    mean_y += y[i];
+  }
+  mean_x /= x.size();
+  mean_y /= y.size();
+  long double m2 = 0.0L, c = 0.0L;
+  for (std::size_t i = 0; i < x.size(); ++i)
+  {
+    m2 += (x[i] - mean_x) * (x[i] - mean_x);
+    c += (x[i] - mean_x) * (y[i] - mean_y);
+  }
+
+  EXPECT_NEAR(parallelMean(x), static_cast<double>(mean_x), 1e-15 * 1e9);
+  EXPECT_NEAR(parallelVariance(x), static_cast<double>(m2 / x.size()), 1e-12);
+  EXPECT_NEAR(parallelCovariance(x, y), static_cast<double>(c / x.size()), 1e-12);
+  auto moments = parallelMoments(x.data(), x.size());
+  EXPECT_EQ(moments.count(), x.size());
+  EXPECT_NEAR(moments.sampleVariance(), static_cast<double>(m2 / (x.size() - 1)), 1e-12);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "statistics/robust/robust.h"
+
+using namespace math::statistics;
+
+// Sort-based reference estimators
+double sortedMedian(std::vector<double> v)
+{
+  std::sort(v.begin(), v.end());
+  std::size_t n = v.size();
+  return n % 2 == 1 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2.0;
+}
+
+double sortedTrimmedMean(std::vector<double> v, double proportion, bool winsorize)
+{
+  std::sort(v.begin(), v.end());
+  std::size_t cut = static_cast<std::size_t>(proportion * v.size());
+  for (std::size_t i = 0; winsorize && i < cut; ++i)
+  {
+    v[i]                = v[cut];
+    v[v.size() - 1 - i] = v[v.size() - 1 - cut];
+  }
+  std::size_t first = winsorize ? 0 : cut, last = winsorize ? v.size() : v.size() - cut;
+  return std::accumulate(v.begin() + first, v.begin() + last, 0.0) / (last - first);
+}
+
+TEST(robust_test, small_inputs)
+{
+  EXPECT_EQ(median(std::vector<int>{3, 1, 2}), 2.0);
+  EXPECT_EQ(median(std::vector<int>{4, 1, 3, 2}), 2.5);
+  EXPECT_EQ(median(std::vector<double>{7.0}), 7.0);
+  // Median 2.5, deviations 1.5 0.5 0.5 1.5: integer input keeps the fractional deviations
+  EXPECT_EQ(mad(std::vector<int>{1, 2, 3, 4}), 1.0);
+  EXPECT_EQ(mad(std::vector<int>{1, 1, 2, 2, 4, 6, 9}), 1.0);
+
+  std::vector<double> v = {1, 2, 3, 4, 5, 6, 7, 8, 9, 1000};
+  EXPECT_DOUBLE_EQ(trimmedMean(v, 0.1), 5.5);
+  EXPECT_DOUBLE_EQ(winsorizedMean(v, 0.1), (2 + 2 + 3 + 4 + 5 + 6 + 7 + 8 + 9 + 9) / 10.0);
+  EXPECT_DOUBLE_EQ(trimmedMean(v, 0.0), 104.5);
+
+  EXPECT_THROW(median(std::vector<double>()), std::invalid_argument);
+  EXPECT_THROW(trimmedMean(v, 0.5), std::invalid_argument);
+  EXPECT_THROW(winsorizedMean(v, -0.1), std::invalid_argument);
+}
+
+TEST(robust_test, matches_sort_based_estimators)
+{
+  std::mt19937_64 gen(1);
+  RobustEstimator<double> estimator;
+  for (std::size_t n : {1, 2, 5, 32, 33, 1000, 99999})
+  {
+    for (int duplicates : {0, 1})
+    {
+      std::vector<double> v(n);
+      for (auto &value : v)
+      {
+        value = duplicates ? static_cast<double>(gen() % 7) : std::normal_distribution<double>(0.0, 1.0)(gen);
+      }
+      const std::vector<double> original = v;
+
+      double center = sortedMedian(v);
+      EXPECT_EQ(estimator.median(v), center) << n;
+      std::vector<double> deviations(n);
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        deviations[i] = std::abs(v[i] - center);
+      }
+      EXPECT_EQ(estimator.mad(v), sortedMedian(deviations)) << n;
+      for (double p : {0.0, 0.1, 0.25, 0.49})
+      {
+        EXPECT_NEAR(estimator.trimmedMean(v, p), sortedTrimmedMean(v, p, false), 1e-12) << n << " " << p;
+        EXPECT_NEAR(estimator.winsorizedMean(v, p), sortedTrimmedMean(v, p, true), 1e-12) << n << " " << p;
+      }
+      EXPECT_EQ(v, original); // the input is never modified
+    }
+  }
+  EXPECT_EQ(estimator.capacity(), 99999u);
+}
+
+TEST(robust_test, outliers)
+{
+  // 10% gross outliers on both sides inflate the variance, not the robust estimates
+  std::mt19937_64 gen(2);
+  std::vector<double> v(100000);
+  for (std::size_t i = 0; i < v.size(); ++i)
+  {
+    v[i] = i % 10 == 0 ? (i % 20 == 0 ? 1e6 : -1e6) : std::normal_distribution<double>(10.0, 2.0)(gen);
+  }
+  RobustEstimator<double> estimator;
+  EXPECT_NEAR(estimator.median(v), 10.0, 0.35);
+  EXPECT_NEAR(kMadNormalScale * estimator.mad(v), 2.0, 0.35);
+  EXPECT_NEAR(estimator.trimmedMean(v, 0.2), 10.0, 0.05);
+  EXPECT_GT(parallelVariance(v), 1e10);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
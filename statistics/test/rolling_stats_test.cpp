@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <iostream>
+#include <random>
+
+#include "statistics/rolling_stats/rolling_stats.h"
+
+using math::statistics::RollingStatistics;
+
+TEST(rolling_stats_test, matches_recomputed_window)
+{
+  std::mt19937_64 gen(1);
+  std::uniform_int_distribution<int> uniform(-50, 50);
+  for (std::size_t window : {1, 2, 7, 64})
+  {
+    RollingStatistics<double> rolling(window);
+    std::deque<double> reference;
+    for (int i = 0; i < 2000; ++i)
+    {
+      double value = uniform(gen) * 0.25;
+      rolling.push(value);
+      reference.push_back(value);
+      if (reference.size() > window) { reference.pop_front(); }
+
+      double mean = 0.0, m2 = 0.0;
+      for (double x : reference)
+      {
+        mean += x;
+      }
+      mean /= reference.size();
+      for (double x : reference)
+      {
+        m2 += (x - mean) * (x - mean);
+      }
+      ASSERT_EQ(rolling.size(), reference.size());
+      ASSERT_NEAR(rolling.mean(), mean, 1e-9);
+      ASSERT_NEAR(rolling.variance(), m2 / reference.size(), 1e-9);
+      ASSERT_EQ(rolling.min(), *std::min_element(reference.begin(), reference.end()));
+      ASSERT_EQ(rolling.max(), *std::max_element(reference.begin(), reference.end()));
+    }
+  }
+
+  RollingStatistics<int> ints(3);
+  EXPECT_TRUE(std::isnan(ints.mean()));
+  for (int value : {5, 1, 4, 4, 9})
+  {
+    ints.push(value);
+  }
+  EXPECT_TRUE(ints.full());
+  EXPECT_EQ(ints.min(), 4);
+  EXPECT_EQ(ints.max(), 9);
+  EXPECT_DOUBLE_EQ(ints.mean(), 17.0 / 3.0);
+  ints.clear();
+  EXPECT_TRUE(ints.empty());
+  EXPECT_THROW(RollingStatistics<double>(0), std::invalid_argument);
+}
+
+TEST(rolling_stats_test, renormalization_bounds_drift)
+{
+  // A level shift of 10^8 followed by a quiet signal: without renormalization M2 keeps the rounding of the shift
+  std::mt19937_64 gen(2);
+  std::normal_distribution<double> noise(0.0, 1e-3);
+  RollingStatistics<double> renormalized(100), drifting(100, 0);
+  for (int i = 0; i < 200000; ++i)
+  {
+    double value = (i % 20000 < 10000 ? 1e8 : 0.0) + noise(gen);
+    renormalized.push(value);
+    drifting.push(value);
+  }
+  // The last 100 values are noise around 0 with variance 10^-6
+  std::cout << "renormalized " << renormalized.variance() << ", never renormalized " << drifting.variance() << std::endl;
+  EXPECT_NEAR(renormalized.variance(), 1e-6, 5e-7);
+  EXPECT_GE(drifting.variance(), 0.0);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -8,6 +8,11 @@ TEST(variance_test, variance)
   vector << 1, 2, 3, 4, 5;
   float variance = math::statistics::computeVariance(vector);
   EXPECT_FLOAT_EQ(variance, 2.0);
+
+  // Single pass in double: a large mean does not cancel the spread
+  Eigen::VectorXf shifted(4);
+  shifted << 10000.5f, 10001.5f, 10002.5f, 10003.5f;
+  EXPECT_FLOAT_EQ(math::statistics::computeVariance(shifted), 1.25f);
 }
 
 TEST(variance_test, covariance)
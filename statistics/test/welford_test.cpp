@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "statistics/welford/welford.h"
+
+using math::statistics::CovarianceAccumulator;
+using math::statistics::WelfordAccumulator;
+
+TEST(welford_test, matches_two_pass)
+{
+  std::vector<double> x = {1.0, 2.0, 3.0, 4.0, 5.0};
+  std::vector<double> y = {2.1, 2.9, 3.2, 4.8, 5.6};
+
+  WelfordAccumulator<double> moments;
+  moments.add(x.begin(), x.end());
+  EXPECT_EQ(moments.count(), 5u);
+  EXPECT_DOUBLE_EQ(moments.mean(), 3.0);
+  EXPECT_DOUBLE_EQ(moments.variance(), 2.0);
+  EXPECT_DOUBLE_EQ(moments.sampleVariance(), 2.5);
+
+  CovarianceAccumulator<double> joint;
+  joint.add(x.begin(), x.end(), y.begin());
+  EXPECT_DOUBLE_EQ(joint.covariance(), 1.78);
+  EXPECT_DOUBLE_EQ(joint.sampleCovariance(), 2.225);
+  EXPECT_DOUBLE_EQ(joint.varianceX(), 2.0);
+  EXPECT_NEAR(joint.correlation(), 1.78 / std::sqrt(2.0 * joint.varianceY()), 1e-12);
+
+  WelfordAccumulator<double> empty;
+  EXPECT_TRUE(std::isnan(empty.variance()));
+  empty.add(1.0);
+  EXPECT_TRUE(std::isnan(empty.sampleVariance()));
+}
+
+TEST(welford_test, large_offset)
+{
+  // Variance 1/4 on top of a mean of 10^9: the sum-of-squares formula loses every digit here
+  WelfordAccumulator<double> moments;
+  double sum = 0.0, sum_squares = 0.0;
+  for (int i = 0; i < 1000000; ++i)
+  {
+    double value = 1e9 + (i % 2 == 0 ? 0.5 : -0.5);
+    moments.add(value);
+    sum += value;
+    sum_squares += value * value;
+  }
+  double naive = sum_squares / 1e6 - (sum / 1e6) * (sum / 1e6);
+  std::cout << "welford " << moments.variance() << ", sum of squares " << naive << std::endl;
+  EXPECT_NEAR(moments.variance(), 0.25, 1e-9);
+}
+
+TEST(welford_test, merge_matches_single_pass)
+{
+  std::mt19937_64 gen(1);
+  std::normal_distribution<double> normal(5.0, 2.0);
+  std::vector<double> x(100003), y(100003);
+  for (std::size_t i = 0; i < x.size(); ++i)
+  {
+    x[i] = normal(gen);
+    y[i] = 0.5 * x[i] + normal(gen);
+  }
+
+  CovarianceAccumulator<double> whole;
+  whole.add(x.begin(), x.end(), y.begin());
+
+  // Uneven shards, including an empty one, merged in order
+  std::vector<std::size_t> cuts = {0, 7, 7, 50000, 99999, x.size()};
+  CovarianceAccumulator<double> merged;
+  WelfordAccumulator<double> merged_x;
+  for (std::size_t s = 0; s + 1 < cuts.size(); ++s)
+  {
+    CovarianceAccumulator<double> shard;
+    shard.add(x.begin() + cuts[s], x.begin() + cuts[s + 1], y.begin() + cuts[s]);
+    merged.merge(shard);
+    WelfordAccumulator<double> shard_x;
+    shard_x.add(x.begin() + cuts[s], x.begin() + cuts[s + 1]);
+    merged_x.merge(shard_x);
+  }
+  EXPECT_EQ(merged.count(), whole.count());
+  EXPECT_NEAR(merged.meanX(), whole.meanX(), 1e-12);
+  EXPECT_NEAR(merged.meanY(), whole.meanY(), 1e-12);
+  EXPECT_NEAR(merged.covariance(), whole.covariance(), 1e-10);
+  EXPECT_NEAR(merged.varianceY(), whole.varianceY(), 1e-10);
+  EXPECT_NEAR(merged_x.variance(), whole.varianceX(), 1e-10);
+  EXPECT_NEAR(merged.correlation(), whole.correlation(), 1e-12);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -1,6 +1,6 @@
+#include <stdexcept>
 
-#include <numeric>
-
+#include "statistics/welford/welford.h"
 #include "variance.h"
 
 namespace math
@@ -9,9 +9,10 @@ namespace statistics
 {
 float computeVariance(const Eigen::VectorXf &vector)
 {
-  float mean           = vector.mean();
-  Eigen::VectorXf diff = vector.array() - mean;
-  return diff.squaredNorm() / vector.size();
+  // One pass in double precision over the coefficients, no temporary for the deviations
+  WelfordAccumulator<double> accumulator;
+  accumulator.add(vector.data(), vector.data() + vector.size());
+  return static_cast<float>(accumulator.variance());
 }
 
 double computeCovariance(const std::vector<double> &X, const std::vector<double> &Y)
@@ -21,19 +22,9 @@ double computeCovariance(const std::vector<double> &X, const std::vector<double>
     throw std::invalid_argument("Vectors must be of the same size and non-empty.");
   }
 
-  std::size_t N = X.size();
-
-  // Compute means
-  double mean_X = std::accumulate(X.begin(), X.end(), 0.0) / N;
-  double mean_Y = std::accumulate(Y.begin(), Y.end(), 0.0) / N;
-
-  // Compute covariance
-  double covariance = 0.0;
-  for (std::size_t i = 0; i < N; ++i)
-  {
-    covariance += (X[i] - mean_X) * (Y[i] - mean_Y);
-  }
-  return covariance / N; // For population covariance; use (N-1) for sample covariance
+  CovarianceAccumulator<double> accumulator;
+  accumulator.add(X.begin(), X.end(), Y.begin());
+  return accumulator.covariance(); // For population covariance; use sampleCovariance() for N-1
 }
 } // namespace statistics
-} // namespace math
\ No newline at end of file
+} // namespace math
@@ -0,0 +1,2 @@
+
+#include "statistics/welford/welford.h"
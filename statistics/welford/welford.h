@@ -0,0 +1,211 @@
+#ifndef STATISTICS_WELFORD_H
+#define STATISTICS_WELFORD_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace math
+{
+namespace statistics
+{
+// Values per block of the range add(): small enough to stay in L1 for the second pass over the block
+constexpr std::size_t kWelfordBlockSize = 256;
+
+/*
+Single-pass moment accumulators (Welford 1962) with the pairwise merge of Chan, Golub and LeVeque (1979).
+
+add() updates the count, the running mean and the sum of squared deviations M2 from the mean, without ever forming
+sum(x^2) - n * mean^2, so a large common offset in the data does not cancel away the variance. merge() combines two
+accumulators as if every value of the other had been added to this one, so partial results of threads or shards
+combine without a second pass over the data.
+
+|property|description|
+|---|---|
+|Passes|one over memory; a range add() passes twice over each block of 256 values while it is in L1. Nothing is allocated.|
+|Memory|count, mean and M2 per series, plus the co-moment for CovarianceAccumulator.|
+|Stability|relative error O(n * eps) independent of the mean, unlike the textbook sum-of-squares formula.|
+|Mergeable|merge() is exact up to rounding; accumulators built in any partition of the data agree.|
+
+variance() and covariance() are population moments (divide by n); the sample versions divide by n - 1. Both are
+NaN for too few values.
+*/
+template <typename T = double>
+class WelfordAccumulator
+{
+ public:
+  void add(T value)
+  {
+    ++count_;
+    const T delta = value - mean_;
+    mean_ += delta / static_cast<T>(count_);
+    m2_ += delta * (value - mean_);
+  }
+
+  // Blocks of kWelfordBlockSize values: mean and M2 of the block from L1, then one merge, no division per value
+  template <typename Iterator>
+  void add(Iterator first, Iterator last)
+  {
+    while (first != last)
+    {
+      Iterator block_end = first;
+      std::size_t m      = 0;
+      T sum              = T(0);
+      for (; block_end != last && m < kWelfordBlockSize; ++block_end, ++m)
+      {
+        sum += static_cast<T>(*block_end);
+      }
+      WelfordAccumulator block;
+      block.count_ = m;
+      block.mean_  = sum / static_cast<T>(m);
+      for (; first != block_end; ++first)
+      {
+        const T delta = static_cast<T>(*first) - block.mean_;
+        block.m2_ += delta * delta;
+      }
+      merge(block);
+    }
+  }
+
+  void merge(const WelfordAccumulator &other)
+  {
+    if (other.count_ == 0) { return; }
+    if (count_ == 0)
+    {
+      *this = other;
+      return;
+    }
+    const T n     = static_cast<T>(count_ + other.count_);
+    const T na    = static_cast<T>(count_);
+    const T nb    = static_cast<T>(other.count_);
+    const T delta = other.mean_ - mean_;
+    mean_ += delta * nb / n;
+    m2_ += other.m2_ + delta * delta * na * nb / n;
+    count_ += other.count_;
+  }
+
+  // Accumulator of count values with the given mean and M2, e.g. computed by another kernel
+  static WelfordAccumulator fromMoments(std::uint64_t count, T mean, T m2)
+  {
+    WelfordAccumulator accumulator;
+    accumulator.count_ = count;
+    accumulator.mean_  = mean;
+    accumulator.m2_    = m2;
+    return accumulator;
+  }
+
+  std::uint64_t count() const { return count_; }
+  T mean() const { return mean_; }
+  T m2() const { return m2_; }
+  T variance() const { return m2_ / static_cast<T>(count_); }
+  T sampleVariance() const { return m2_ / (static_cast<T>(count_) - T(1)); }
+
+ private:
+  std::uint64_t count_ = 0;
+  T mean_              = T(0);
+  T m2_                = T(0);
+};
+
+// Joint moments of a series of (x, y) pairs: both means and variances and the co-moment sum((x - mx) * (y - my))
+template <typename T = double>
+class CovarianceAccumulator
+{
+ public:
+  void add(T x, T y)
+  {
+    ++count_;
+    const T n  = static_cast<T>(count_);
+    const T dx = x - mean_x_;
+    const T dy = y - mean_y_;
+    mean_x_ += dx / n;
+    mean_y_ += dy / n;
+    m2_x_ += dx * (x - mean_x_);
+    m2_y_ += dy * (y - mean_y_);
+    c_ += dx * (y - mean_y_);
+  }
+
+  template <typename IteratorX, typename IteratorY>
+  void add(IteratorX first_x, IteratorX last_x, IteratorY first_y)
+  {
+    while (first_x != last_x)
+    {
+      IteratorX block_end_x = first_x;
+      IteratorY y           = first_y;
+      std::size_t m         = 0;
+      T sum_x = T(0), sum_y = T(0);
+      for (; block_end_x != last_x && m < kWelfordBlockSize; ++block_end_x, ++y, ++m)
+      {
+        sum_x += static_cast<T>(*block_end_x);
+        sum_y += static_cast<T>(*y);
+      }
+      CovarianceAccumulator block;
+      block.count_  = m;
+      block.mean_x_ = sum_x / static_cast<T>(m);
+      block.mean_y_ = sum_y / static_cast<T>(m);
+      for (; first_x != block_end_x; ++first_x, ++first_y)
+      {
+        const T dx = static_cast<T>(*first_x) - block.mean_x_;
+        const T dy = static_cast<T>(*first_y) - block.mean_y_;
+        block.m2_x_ += dx * dx;
+        block.m2_y_ += dy * dy;
+        block.c_ += dx * dy;
+      }
+      merge(block);
+    }
+  }
+
+  void merge(const CovarianceAccumulator &other)
+  {
+    if (other.count_ == 0) { return; }
+    if (count_ == 0)
+    {
+      *this = other;
+      return;
+    }
+    const T n      = static_cast<T>(count_ + other.count_);
+    const T weight = static_cast<T>(count_) * static_cast<T>(other.count_) / n;
+    const T dx     = other.mean_x_ - mean_x_;
+    const T dy     = other.mean_y_ - mean_y_;
+    mean_x_ += dx * static_cast<T>(other.count_) / n;
+    mean_y_ += dy * static_cast<T>(other.count_) / n;
+    m2_x_ += other.m2_x_ + dx * dx * weight;
+    m2_y_ += other.m2_y_ + dy * dy * weight;
+    c_ += other.c_ + dx * dy * weight;
+    count_ += other.count_;
+  }
+
+  static CovarianceAccumulator fromMoments(std::uint64_t count, T mean_x, T mean_y, T m2_x, T m2_y, T comoment)
+  {
+    CovarianceAccumulator accumulator;
+    accumulator.count_  = count;
+    accumulator.mean_x_ = mean_x;
+    accumulator.mean_y_ = mean_y;
+    accumulator.m2_x_   = m2_x;
+    accumulator.m2_y_   = m2_y;
+    accumulator.c_      = comoment;
+    return accumulator;
+  }
+
+  std::uint64_t count() const { return count_; }
+  T meanX() const { return mean_x_; }
+  T meanY() const { return mean_y_; }
+  T comoment() const { return c_; }
+  T varianceX() const { return m2_x_ / static_cast<T>(count_); }
+  T varianceY() const { return m2_y_ / static_cast<T>(count_); }
+  T covariance() const { return c_ / static_cast<T>(count_); }
+  T sampleCovariance() const { return c_ / (static_cast<T>(count_) - T(1)); }
+  // Pearson correlation coefficient
+  T correlation() const { return c_ / std::sqrt(m2_x_ * m2_y_); }
+
+ private:
+  std::uint64_t count_ = 0;
+  T mean_x_            = T(0);
+  T mean_y_            = T(0);
+  T m2_x_              = T(0);
+  T m2_y_              = T(0);
+  T c_                 = T(0);
+};
+} // namespace statistics
+} // namespace math
+
+#endif